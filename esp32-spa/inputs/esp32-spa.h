@@ -3,6 +3,8 @@
 #include "esphome.h"
 #include "esphome/core/log.h"
 #include "esphome/components/sensor/sensor.h"  // ensure Sensor base class is available
+#include <cmath>
+#include <cstring>
 #include <string>
 #include <utility>
 
@@ -16,9 +18,18 @@ namespace esphome { namespace text_sensor { class TextSensor; } }
 #include "freertos/portmacro.h"
 #include "esp_timer.h"
 
+// lwIP sockets for the optional raw-frame stream (UDP)
+#include "lwip/sockets.h"
+#include "esphome/components/network/util.h"
+
 // Forward declaration of C ISR wrapper (defined after the namespace)
 extern "C" void esp32_spa_isr_wrapper(void* arg);
 
+#ifndef __XTENSA__
+// Off-target builds (tools/host) provide a virtual CPU cycle counter
+extern "C" uint32_t esp32_spa_host_cycle_count();
+#endif
+
 static const char *TAG = "esp32-spa";
 
 // ===== PIN DEFINITIONS =====
@@ -36,8 +47,213 @@ static const uint8_t DATA_PIN = 34;  // Data (input-only)
 
 namespace esp32_spa {
 
+// ===== PROTOCOL DESCRIPTORS =====
+// Frame layout of a topside variant, resolved at compile time. A frame carries a status/hundreds
+// field p1, two 7-segment glyph fields p2 (tens) and p3 (ones), and optionally a short status
+// field p4. A descriptor gives each field's offset (in bits from the first bit clocked in) and
+// width, the checksum rules, the status bit positions and the segment wiring of the glyph fields.
+// A variant that differs only in those can be supported by adding a descriptor and building with
+// -DESP32_SPA_PROTOCOL=esp32_spa::YourProtocol. A different set of fields (a third digit, a
+// decimal point, more status fields) or frames longer than 24 bits still need code changes.
+struct Gs100Protocol {
+  static constexpr uint8_t P1_OFFSET = 0,  P1_WIDTH = 7;   // status / hundreds
+  static constexpr uint8_t P2_OFFSET = 7,  P2_WIDTH = 7;   // tens glyph
+  static constexpr uint8_t P3_OFFSET = 14, P3_WIDTH = 7;   // ones glyph
+  static constexpr uint8_t P4_OFFSET = 21, P4_WIDTH = 3;   // status bits
+  static constexpr uint8_t MIN_FRAME_BITS = 21;  // frames without p4 are still decodable
+  static constexpr uint8_t FRAME_BITS = 24;
+
+  // Checksum rules: (p1 & mask) == value, and (p4 & mask) == value when p4 is present
+  static constexpr uint8_t P1_CHECK_MASK = 0x4B;    // 0b1001011 (bits 6,3,1,0 of p1)
+  static constexpr uint8_t P1_CHECK_VALUE = 0x00;
+  static constexpr uint8_t P4_CHECK_MASK = 0x1;     // p4 LSB
+  static constexpr uint8_t P4_CHECK_VALUE = 0x0;
+
+  static constexpr uint8_t HUNDREDS_MASK = 0x30;    // bits 5&4 of p1 both high = +100
+  static constexpr uint8_t HEATER_BIT = 2;          // in p1
+  static constexpr uint8_t PUMP_BIT = 2;            // in p4
+  static constexpr uint8_t LIGHT_BIT = 1;           // in p4
+
+  // Bit of p2/p3 that drives each segment, in order a (top), b, c, d, e, f, g (center)
+  static constexpr uint8_t SEGMENT_BITS[7] = {6, 5, 4, 3, 2, 1, 0};
+};
+
+#ifndef ESP32_SPA_PROTOCOL
+#define ESP32_SPA_PROTOCOL esp32_spa::Gs100Protocol
+#endif
+
+// Fields of one frame, split according to a protocol descriptor.
+// p2/p3 are returned in canonical segment order (bit6 = a ... bit0 = g) for the glyph tables.
+struct FrameFields {
+  uint8_t p1, p2, p3, p4;
+  bool has_status;  // frame was long enough to carry p4
+};
+
+// 7-segment glyphs in canonical segment order (bit6 = a/top, bit5 = b/upper right, bit4 = c/lower
+// right, bit3 = d/bottom, bit2 = e/lower left, bit1 = f/upper left, bit0 = g/middle).
+// The host emulator (tools/host) encodes its frames from these same tables.
+static constexpr uint8_t SEVEN_SEG_DIGITS[10] = {
+  0b1111110, // 0
+  0b0110000, // 1
+  0b1101101, // 2
+  0b1111001, // 3
+  0b0110011, // 4
+  0b1011011, // 5
+  0b1011111, // 6
+  0b1110000, // 7
+  0b1111111, // 8
+  0b1110011  // 9
+};
+
+struct SevenSegLetter {
+  uint8_t pattern;
+  char ch;
+};
+// Known letter/dash patterns (approximate common 7-seg shapes) used in error and mode codes
+static constexpr SevenSegLetter SEVEN_SEG_LETTERS[] = {
+  {0b0000001, '-'}, // dash (g)
+  {0b0110111, 'H'}, // H
+  {0b1111110, 'O'}, // O
+  {0b0110000, 'I'}, // I
+  {0b1001110, 'C'}, // C
+  {0b1110111, 'A'}, // A
+  {0b0011111, 'b'}, // b
+  {0b0001110, 'L'}, // L
+  {0b1000111, 'F'}, // F
+  {0b0111011, 'Y'}, // Y
+  {0b0111101, 'd'}, // d
+  {0b0000101, 'r'}, // r
+  {0b1011011, 'S'}, // S
+  {0b0010101, 'n'}, // n
+  {0b1001111, 'E'}, // E
+  {0b0001111, 't'}, // t
+  {0b0001101, 'c'}  // c
+};
+
+// Decode helpers specialised per protocol; everything folds to the same shifts and masks
+// as hand-written code for a fixed layout.
+template<typename P> struct FrameDecoder {
+  static_assert(P::FRAME_BITS <= 24, "stream/ISR frame storage assumes at most 24 bits");
+  static_assert(P::P1_OFFSET + P::P1_WIDTH <= P::MIN_FRAME_BITS && P::P2_OFFSET + P::P2_WIDTH <= P::MIN_FRAME_BITS &&
+                P::P3_OFFSET + P::P3_WIDTH <= P::MIN_FRAME_BITS, "p1..p3 must fit in the minimum frame");
+  static_assert(P::P4_OFFSET >= P::MIN_FRAME_BITS && P::P4_OFFSET + P::P4_WIDTH <= P::FRAME_BITS,
+                "p4 must lie between the minimum and the full frame length");
+  static_assert(P::P2_WIDTH == 7 && P::P3_WIDTH == 7, "glyph fields are 7 segments wide");
+
+  // The field at OFF..OFF+W (counted from the first bit) of an nbits-long MSB-first frame.
+  // Shorter frames are truncated at the end, so leading fields keep their offsets.
+  template<uint8_t OFF, uint8_t W> static inline uint8_t field(uint32_t value, uint8_t nbits) {
+    return (value >> (nbits - OFF - W)) & ((1u << W) - 1);
+  }
+
+  static constexpr bool canonical_segments() {
+    for (uint8_t i = 0; i < 7; ++i) if (P::SEGMENT_BITS[i] != 6 - i) return false;
+    return true;
+  }
+  // Reorder a glyph field into canonical segment order (a no-op for GS100 wiring)
+  static inline uint8_t glyph(uint8_t raw) {
+    if constexpr (canonical_segments()) {
+      return raw;
+    } else {
+      uint8_t seg = 0;
+      for (uint8_t i = 0; i < 7; ++i) seg |= ((raw >> P::SEGMENT_BITS[i]) & 0x1) << (6 - i);
+      return seg;
+    }
+  }
+
+  static inline FrameFields split(uint32_t value, uint8_t nbits) {
+    FrameFields f;
+    f.p1 = field<P::P1_OFFSET, P::P1_WIDTH>(value, nbits);
+    f.p2 = glyph(field<P::P2_OFFSET, P::P2_WIDTH>(value, nbits));
+    f.p3 = glyph(field<P::P3_OFFSET, P::P3_WIDTH>(value, nbits));
+    f.has_status = (nbits >= P::P4_OFFSET + P::P4_WIDTH);
+    f.p4 = f.has_status ? field<P::P4_OFFSET, P::P4_WIDTH>(value, nbits) : 0;
+    return f;
+  }
+  static inline bool p1_ok(const FrameFields &f) { return (f.p1 & P::P1_CHECK_MASK) == P::P1_CHECK_VALUE; }
+  static inline bool p4_ok(const FrameFields &f) {
+    return !f.has_status || (f.p4 & P::P4_CHECK_MASK) == P::P4_CHECK_VALUE;
+  }
+  static inline bool hundreds(uint8_t p1) { return (p1 & P::HUNDREDS_MASK) == P::HUNDREDS_MASK; }
+  static inline int8_t heater(const FrameFields &f) { return static_cast<int8_t>((f.p1 >> P::HEATER_BIT) & 0x1); }
+  static inline int8_t pump(const FrameFields &f) { return static_cast<int8_t>((f.p4 >> P::PUMP_BIT) & 0x1); }
+  static inline int8_t light(const FrameFields &f) { return static_cast<int8_t>((f.p4 >> P::LIGHT_BIT) & 0x1); }
+};
+
+// ===== DISPLAY STATE MACHINE =====
+// What the topside display is currently showing, as interpreted from stable frames.
+//   NORMAL     - measured temperature
+//   SET_FLASH  - set-temp flash sequence (set temp alternating with blanks)
+//   MODE_SHOWN - mode string (St/Ec/SL) shown during the flash sequence after a Light press
+//   ERROR      - a stable error code
+//   STALLED    - no valid frames (bus watchdog)
+enum class DisplayState : uint8_t { NORMAL, SET_FLASH, MODE_SHOWN, ERROR, STALLED, COUNT };
+
+enum class DisplayEvent : uint8_t {
+  SET_INDICATOR,  // stable blank (or mode string not yet stable)
+  MODE_STRING,    // stable mode string
+  ERROR_SHOWN,    // stable error code
+  TEMP_SHOWN,     // stable numeric temperature
+  SET_TIMEOUT,    // no set indicator for the state's timeout
+  BUS_STALL,
+  BUS_RECOVER,
+};
+
+struct DisplayTransition {
+  DisplayState from;
+  DisplayEvent event;
+  DisplayState to;
+};
+
+// Events with no matching row are ignored in that state
+static constexpr DisplayTransition DISPLAY_TRANSITIONS[] = {
+  {DisplayState::NORMAL,     DisplayEvent::SET_INDICATOR, DisplayState::SET_FLASH},
+  {DisplayState::NORMAL,     DisplayEvent::MODE_STRING,   DisplayState::MODE_SHOWN},
+  {DisplayState::NORMAL,     DisplayEvent::ERROR_SHOWN,   DisplayState::ERROR},
+  {DisplayState::SET_FLASH,  DisplayEvent::MODE_STRING,   DisplayState::MODE_SHOWN},
+  {DisplayState::SET_FLASH,  DisplayEvent::SET_TIMEOUT,   DisplayState::NORMAL},
+  {DisplayState::SET_FLASH,  DisplayEvent::ERROR_SHOWN,   DisplayState::ERROR},
+  {DisplayState::MODE_SHOWN, DisplayEvent::SET_INDICATOR, DisplayState::SET_FLASH},
+  {DisplayState::MODE_SHOWN, DisplayEvent::SET_TIMEOUT,   DisplayState::NORMAL},
+  {DisplayState::MODE_SHOWN, DisplayEvent::ERROR_SHOWN,   DisplayState::ERROR},
+  {DisplayState::ERROR,      DisplayEvent::TEMP_SHOWN,    DisplayState::NORMAL},
+  {DisplayState::ERROR,      DisplayEvent::SET_INDICATOR, DisplayState::SET_FLASH},
+  {DisplayState::ERROR,      DisplayEvent::MODE_STRING,   DisplayState::MODE_SHOWN},
+  {DisplayState::NORMAL,     DisplayEvent::BUS_STALL,     DisplayState::STALLED},
+  {DisplayState::SET_FLASH,  DisplayEvent::BUS_STALL,     DisplayState::STALLED},
+  {DisplayState::MODE_SHOWN, DisplayEvent::BUS_STALL,     DisplayState::STALLED},
+  {DisplayState::ERROR,      DisplayEvent::BUS_STALL,     DisplayState::STALLED},
+  {DisplayState::STALLED,    DisplayEvent::BUS_RECOVER,   DisplayState::NORMAL},
+};
+static constexpr size_t NUM_DISPLAY_TRANSITIONS = sizeof(DISPLAY_TRANSITIONS) / sizeof(DISPLAY_TRANSITIONS[0]);
+
+// Per-state timeout (ms since the last set indicator) that fires SET_TIMEOUT; 0 = none
+static constexpr uint32_t SET_MODE_TIMEOUT_MS = 2000;  // 2 seconds without a set indicator = exit set mode
+static constexpr uint32_t DISPLAY_STATE_TIMEOUT_MS[static_cast<size_t>(DisplayState::COUNT)] = {
+  0,                    // NORMAL
+  SET_MODE_TIMEOUT_MS,  // SET_FLASH
+  SET_MODE_TIMEOUT_MS,  // MODE_SHOWN
+  0,                    // ERROR
+  0,                    // STALLED (left by BUS_RECOVER)
+};
+
+static inline const char *display_state_name(DisplayState s) {
+  switch (s) {
+    case DisplayState::NORMAL:     return "Normal";
+    case DisplayState::SET_FLASH:  return "SetFlash";
+    case DisplayState::MODE_SHOWN: return "ModeShown";
+    case DisplayState::ERROR:      return "Error";
+    case DisplayState::STALLED:    return "Stalled";
+    default:                       return "?";
+  }
+}
+
 class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::Sensor {
  public:
+  // Topside frame layout (compile-time; see PROTOCOL DESCRIPTORS above)
+  using Protocol = ESP32_SPA_PROTOCOL;
+  using Frame = FrameDecoder<Protocol>;
+
   // ---- Shared with ISR ----
   volatile uint32_t shift_reg = 0;
   volatile uint8_t bit_count = 0;
@@ -47,7 +263,7 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   // ---- Publish control ----
   uint32_t last_publish_time = 0;
   uint32_t last_published_value = 0;
-  uint8_t  last_published_bits = 24;
+  uint8_t  last_published_bits = Protocol::FRAME_BITS;
   bool first_publish = true;
   volatile bool last_frame_valid = false;  // becomes true when a frame passes the checksum and is published
   volatile uint32_t completed_frame = 0;   // frame data saved by ISR pending loop() read
@@ -56,19 +272,23 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   // Remember last decoded values for change detection
   int16_t last_measured_temp = -1;  // -1 = unknown
   int16_t last_set_temp = -1;       // -1 = unknown
+  // Set-temp capture, owned by the SET_FLASH / MODE_SHOWN handling (handle_set_mode_); cleared
+  // whenever the display leaves set mode
   int16_t set_temp_potential = -1;  // candidate for set temp
-  uint32_t last_zero_seen_time = 0; // last time we saw 0x00 in p2/p3
+  uint32_t set_temp_potential_since_ms_ = 0;  // when the digits behind set_temp_potential were first shown
   uint32_t last_candidate_temp_time = 0; // last time we saw a candidate temp while in set mode
-  bool in_set_mode = false;         // true when we've seen 0x00 recently
+  // A set-temp candidate must have been seen this recently to be confirmed
+  static constexpr uint32_t CANDIDATE_FRESH_MS = 3000;
 
-  // Pending measured temp publish (to avoid misreading brief set-mode flashes as measured temp)
-  int16_t pending_measured_temp = -1;        // -1 = none pending
-  uint32_t pending_measured_since = 0;       // time when pending started (ms)
-  static constexpr uint32_t MEASURE_PUBLISH_DELAY_MS = 500;  // delay before publishing measured temp (ms)
+  // NORMAL handling (handle_normal_): a temperature must be on show this long, in NORMAL, before it
+  // is published as the measured temp; the set-temp flash starts with the set temp digits
+  static constexpr uint32_t MEASURE_PUBLISH_DELAY_MS = 500;
 
-  // Stability tracking (counters and candidates)
+  // Stability tracking (counters and candidates). These debounce the frame input of the display
+  // state machine; they do not hold display state themselves.
   int16_t candidate_temp = -2; uint8_t stable_temp = 0;
-  bool candidate_is_zero = false; uint8_t stable_zero = 0;
+  uint32_t candidate_temp_since_ms_ = 0;  // first frame of the current candidate_temp run
+  bool candidate_is_zero = false; uint8_t stable_zero = 0;  // set indicator (blank or mode string)
   // Heater stability (derived from bit5 of p1)
   int8_t candidate_heater = -2; uint8_t stable_heater = 0;
   // Pump & light stability (derived from p4 bits)
@@ -78,8 +298,12 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   // Sensors for temperature readings
   esphome::sensor::Sensor *measured_temp_sensor_ = nullptr;
   esphome::sensor::Sensor *set_temp_sensor_ = nullptr;
+  // Optional diagnostic sensor: button press -> confirmed set-temp/mode capture latency (ms)
+  esphome::sensor::Sensor *press_latency_sensor_ = nullptr;
   // Text sensor for error codes
   esphome::text_sensor::TextSensor *error_text_sensor_ = nullptr;
+  // Diagnostic text sensor for the bus watchdog ("ok" / "stalled")
+  esphome::text_sensor::TextSensor *bus_state_text_sensor_ = nullptr;
 
   // Binary sensors for discrete states
   esphome::binary_sensor::BinarySensor *heater_sensor_ = nullptr;  // derived from p1 bit5
@@ -103,9 +327,18 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   std::string last_mode_ = "";
   std::string candidate_mode_ = "";
   uint8_t stable_mode_ = 0;
+  uint32_t candidate_mode_since_ms_ = 0;  // first frame of the current candidate_mode_ run
   static constexpr uint8_t MODE_STABLE_THRESHOLD = 3;
 
-  static constexpr uint32_t HEARTBEAT_MS = 30000;  // heartbeat every 30s (publish if unchanged)
+  uint32_t heartbeat_ms_ = 30000;  // heartbeat every 30s (publish if unchanged); 0 = disabled
+
+  // --- API reconnect snapshot ---
+  // When an API client connects (api: on_client_connected -> on_api_client_connected()), push
+  // every cached value once instead of waiting for a change or the next heartbeat. The fixed
+  // delay lets the client finish subscribing to states first; it is not a measured latency.
+  static constexpr uint32_t API_SNAPSHOT_DELAY_MS = 200;
+  uint8_t api_clients_ = 0;
+  uint32_t api_last_disconnect_ms_ = 0;
   // Gap threshold (ms) to consider the start of a new frame (use ~15ms to match ~19ms observed gap)
   static constexpr uint32_t FRAME_GAP_MS =5;
   static constexpr uint32_t FRAME_GAP_US = FRAME_GAP_MS * 1000;
@@ -116,58 +349,167 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   static constexpr uint8_t PUMP_STABLE_THRESHOLD = 3;  // pump requires 3 repeats to be considered stable
   // Error codes are noisier — require more repeats to consider stable
   static constexpr uint8_t ERROR_STABLE_THRESHOLD = 3;
-  static constexpr uint32_t SET_MODE_TIMEOUT_MS = 2000;  // 2 seconds without 0x00 = exit set mode
   static constexpr uint32_t HEATER_OFF_TIMEOUT_MS = 1000; // heater must be off for 1s before clearing
 
   // Timestamp to track when heater bit last went low while heater was on
   uint32_t last_heater_off_time = 0;
 
+  // --- Bus-stall watchdog ---
+  // If no frame passes the checksums for stall_timeout_ms_, the topside cable is unplugged or the
+  // controller is rebooting: set the entities to unknown instead of heartbeating stale values.
+  // The first valid frame recovers automatically.
+  uint32_t stall_timeout_ms_ = 1000;
+  uint32_t last_valid_frame_ms_ = 0;
+  uint32_t valid_frame_count_ = 0;   // frames that passed the checksums (incl. resync recoveries)
+  bool bus_state_reported_ = false;  // "ok" is published once on the first valid frame after boot
+  uint32_t bus_stall_count_ = 0;
+
+  // --- Press-to-confirmed-publish latency ---
+  // note_temp_press() / note_light_press() are called for injected presses (from the YAML buttons
+  // and the automatic refresh press). Only evidence that first appeared after the press closes the
+  // measurement: for Warm/Cool a set-temp publish, or a set-temp capture of digits first shown after
+  // the press; for Light a mode string first shown after the press, or a light state change.
+  // A press with no confirmation within PRESS_CONFIRM_TIMEOUT_MS counts as missed.
+  static constexpr uint32_t PRESS_CONFIRM_TIMEOUT_MS = 10000;
+  bool press_pending_ = false;
+  bool press_is_light_ = false;
+  uint32_t press_pending_since_ms_ = 0;
+  uint32_t press_latency_count_ = 0;
+  uint32_t press_latency_sum_ms_ = 0;
+  uint32_t press_latency_min_ms_ = UINT32_MAX;
+  uint32_t press_latency_max_ms_ = 0;
+  uint32_t press_latency_missed_ = 0;
+
+  // --- Display state machine (see DISPLAY_TRANSITIONS) ---
+  // Every transition records how long the display stayed in its source state, per table row.
+  struct TransitionStats {
+    uint32_t count = 0;
+    uint32_t last_ms = 0;
+    uint32_t max_ms = 0;
+    uint32_t total_ms = 0;
+  };
+  DisplayState display_state_ = DisplayState::NORMAL;
+  uint32_t state_entered_ms_ = 0;    // set in setup() so the first dwell is not measured from boot
+  uint32_t state_refreshed_ms_ = 0;  // last set indicator; DISPLAY_STATE_TIMEOUT_MS counts from here
+  TransitionStats transition_stats_[NUM_DISPLAY_TRANSITIONS];
+  // Set-temp capture path: entering set mode -> first fresh set-temp capture
+  uint32_t set_mode_started_ms_ = 0;
+  bool set_capture_recorded_ = false;
+  TransitionStats set_capture_stats_;
+  static constexpr uint32_t STATE_STATS_LOG_MS = 10u * 60u * 1000u;  // log summary every 10 minutes
+  uint32_t last_state_stats_log_ms_ = 0;
+
+  bool in_set_mode() const { return display_state_ == DisplayState::SET_FLASH || display_state_ == DisplayState::MODE_SHOWN; }
+  bool bus_stalled() const { return display_state_ == DisplayState::STALLED; }
+  DisplayState display_state() const { return display_state_; }
+  const TransitionStats &transition_stats(size_t row) const { return transition_stats_[row]; }
+  const TransitionStats &set_capture_stats() const { return set_capture_stats_; }
+  uint32_t valid_frames() const { return valid_frame_count_; }
+  uint32_t partial_frames() const { return total_partial_frames_; }
+  uint32_t glitches_rejected() const { return glitch_count_; }
+  uint32_t resync_recovered() const { return resync_recovered_; }
+  uint32_t resync_failed() const { return resync_failed_; }
+  uint32_t stream_packets_sent() const { return stream_packets_sent_; }
+  uint32_t stream_send_drops() const { return stream_send_drops_; }
+
   // --- Auto-refresh set-temp logic ---
   // When we capture & publish the set temp, reset this timer. If no set-temp is captured
   // for SET_FORCE_INTERVAL_MS milliseconds we auto-press COOL once to force the tub to
   // display and send the set temperature. We also update the timer when we auto-press.
   uint32_t last_set_sent_time_ms = 0;
   static constexpr uint32_t SET_FORCE_INTERVAL_MS = 30u * 60u * 1000u;  // 30 minutes
-  
+
+  // --- Raw-frame stream (optional UDP endpoint) ---
+  // Subscribers send "SUB <token>" to the stream port to subscribe (and must repeat it as a
+  // keepalive); "BYE <token>" unsubscribes. Datagrams without the configured token are ignored,
+  // so a spoofed or stray packet cannot make the device stream to an arbitrary address. Captured frames are batched into binary packets, no text
+  // is formatted per frame. Sends are non-blocking: a subscriber whose socket buffer is full
+  // simply misses that packet, and is dropped after too many consecutive failures.
+  static constexpr uint8_t  STREAM_MAX_SUBSCRIBERS = 8;      // hard capacity of the subscriber table
+  static constexpr uint8_t  STREAM_BATCH_FRAMES = 32;        // frames per packet (flush when full)
+  static constexpr uint32_t STREAM_FLUSH_MS = 100;           // ... or when the oldest frame is this old
+  static constexpr uint32_t STREAM_SUBSCRIBER_TIMEOUT_MS = 15000;  // drop silent subscribers
+  static constexpr uint8_t  STREAM_MAX_SEND_FAILURES = 20;   // consecutive failed sends before eviction
+  static constexpr uint32_t STREAM_REOPEN_MS = 5000;         // retry interval for socket setup
+  static constexpr uint32_t STREAM_STATS_LOG_MS = 60000;     // periodic stats log while subscribed
+  static constexpr uint8_t  STREAM_VERSION = 2;
+  static constexpr size_t   STREAM_HEADER_SIZE = 28;         // see build_stream_header_()
+  static constexpr size_t   STREAM_ENTRY_SIZE = 8;           // u32 timestamp_us + u32 (bits<<24 | raw)
+  static constexpr size_t   STREAM_MAX_TOKEN = 32;           // matches the stream_token length limit
+
+  uint16_t stream_port_ = 0;                 // 0 = streaming disabled
+  uint8_t  stream_max_subscribers_ = 2;
+  std::string stream_token_;                 // required in every subscribe/unsubscribe datagram
+
   // Setters called from Python binding
   void set_measured_temp_sensor(esphome::sensor::Sensor *s) { measured_temp_sensor_ = s; }
   void set_set_temp_sensor(esphome::sensor::Sensor *s) { set_temp_sensor_ = s; }
+  void set_press_latency_sensor(esphome::sensor::Sensor *s) { press_latency_sensor_ = s; }
   void set_error_text_sensor(esphome::text_sensor::TextSensor *s) { error_text_sensor_ = s; }
   void set_spa_mode_text_sensor(esphome::text_sensor::TextSensor *s) { spa_mode_text_sensor_ = s; }
+  void set_bus_state_text_sensor(esphome::text_sensor::TextSensor *s) { bus_state_text_sensor_ = s; }
+  void set_stall_timeout(uint32_t ms) { stall_timeout_ms_ = ms; }
+  void set_heartbeat_interval(uint32_t ms) { heartbeat_ms_ = ms; }
+  // Reject clock edges closer than this to the previous accepted edge (0 = filter off)
+  void set_glitch_filter_us(uint32_t us) { glitch_filter_cycles_ = us * CYCLES_PER_US; }
 
   // Binary sensor setters
   void set_heater_sensor(esphome::binary_sensor::BinarySensor *s) { heater_sensor_ = s; }
   void set_pump_sensor(esphome::binary_sensor::BinarySensor *s) { pump_sensor_ = s; }
   void set_light_sensor(esphome::binary_sensor::BinarySensor *s) { light_sensor_ = s; }
 
+  // Called per client from the api: on_client_connected / on_client_disconnected triggers, so a
+  // second client (e.g. Home Assistant reconnecting while a log client is attached) gets its own
+  // snapshot. Clients connecting within the delay share one snapshot (it goes to every client).
+  void on_api_client_connected(const std::string &client_info) {
+    uint32_t now = esphome::millis();
+    api_clients_++;
+    if (api_last_disconnect_ms_ != 0) {
+      ESP_LOGI(TAG, "API client connected: %s (%u connected, last disconnect %ums ago)", client_info.c_str(),
+               static_cast<unsigned>(api_clients_), static_cast<unsigned>(now - api_last_disconnect_ms_));
+    } else {
+      ESP_LOGI(TAG, "API client connected: %s (%u connected)", client_info.c_str(), static_cast<unsigned>(api_clients_));
+    }
+    this->set_timeout("api_snapshot", API_SNAPSHOT_DELAY_MS, [this]() {
+      uint8_t n = publish_snapshot_();
+      ESP_LOGI(TAG, "API snapshot: published %u cached entities after the fixed %ums delay", static_cast<unsigned>(n),
+               static_cast<unsigned>(API_SNAPSHOT_DELAY_MS));
+    });
+  }
+  void on_api_client_disconnected(const std::string &client_info) {
+    if (api_clients_ > 0) api_clients_--;
+    api_last_disconnect_ms_ = esphome::millis();
+    ESP_LOGI(TAG, "API client disconnected: %s (%u connected)", client_info.c_str(),
+             static_cast<unsigned>(api_clients_));
+  }
+
+  // Start a press-to-confirmed-publish latency measurement (a newer press restarts it)
+  void note_temp_press() { start_press_(false); }   // Warm / Cool
+  void note_light_press() { start_press_(true); }   // Light
+
+  // Raw-frame stream setters
+  void set_stream_port(uint16_t port) { stream_port_ = port; }
+  void set_stream_token(const std::string &token) { stream_token_ = token.substr(0, STREAM_MAX_TOKEN); }
+  void set_stream_max_subscribers(uint8_t n) {
+    stream_max_subscribers_ = (n == 0) ? 1 : (n > STREAM_MAX_SUBSCRIBERS ? STREAM_MAX_SUBSCRIBERS : n);
+  }
+
 
 
   
   // Decode temperature from p1, p2, p3
-  // p2 = tens digit, p3 = ones digit, bits 5&4 of p1 both high = add 100
+  // p2 = tens digit, p3 = ones digit, hundreds flag in p1 (Protocol::HUNDREDS_MASK) = add 100
   static int16_t decode_temp(uint8_t p1, int8_t d2, int8_t d3) {
     if (d2 < 0 || d3 < 0) return -1;  // invalid digits
     int16_t temp = d2 * 10 + d3;
-    // Check bits 5 and 4 of p1 (0b00110000 = 0x30)
-    if ((p1 & 0x30) == 0x30) {
+    if (Frame::hundreds(p1)) {
       temp += 100;
     }
     return temp;
   }
   static int8_t decode_7seg(uint8_t seg) {
-    // bit ordering: bit6=a(top), bit5=b(upper right), bit4=c(lower right), bit3=d(bottom), bit2=e(lower left), bit1=f(upper left), bit0=g(middle)
-    static const uint8_t map[10] = {
-      0b1111110, // 0
-      0b0110000, // 1
-      0b1101101, // 2
-      0b1111001, // 3
-      0b0110011, // 4
-      0b1011011, // 5
-      0b1011111, // 6
-      0b1110000, // 7
-      0b1111111, // 8
-      0b1110011  // 9
-    };
+    // canonical segment order (see FrameFields and SEVEN_SEG_DIGITS)
+    const uint8_t *map = SEVEN_SEG_DIGITS;
 
     // Only accept exact matches to avoid occasional 1-bit misreads causing spurious digits.
     for (uint8_t d = 0; d < 10; ++d) {
@@ -186,36 +528,15 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   // Decode a 7-seg pattern into a single character used in error codes.
   // Returns '\0' if unknown.
   static char decode_7seg_char(uint8_t seg) {
-    // Known letter/dash patterns (approximate common 7-seg shapes)
-    const std::pair<uint8_t,char> letters[] = {
-      {0b0000001, '-'}, // dash (g)
-      {0b0110111, 'H'}, // H
-      {0b1111110, 'O'}, // O 
-      {0b0110000, 'I'}, // I 
-      {0b1001110, 'C'}, // C
-      {0b1110111, 'A'}, // A
-      {0b0011111, 'b'}, // b
-      {0b0001110, 'L'}, // L
-      {0b1000111, 'F'}, // F
-      {0b0111011, 'Y'}, // Y
-      {0b0111101, 'd'}, // d 
-      {0b0000101, 'r'}, // r
-      {0b1011011, 'S'}, // S 
-      {0b0010101, 'n'}, // n 
-      {0b1001111, 'E'}, // E 
-      {0b0001111, 't'}, // t 
-      {0b0001101, 'c'}  // c 
-    };
-
     // Prefer letter matches only (we intentionally avoid returning digits here)
-    for (auto &p : letters) {
-      if (seg == p.first) return p.second;
+    for (auto &p : SEVEN_SEG_LETTERS) {
+      if (seg == p.pattern) return p.ch;
     }
 
     // Try reversed bit order too (for wiring/order mismatches)
     uint8_t rev = 0;
     for (int i = 0; i < 7; ++i) rev |= ((seg >> i) & 0x1) << (6 - i);
-    for (auto &p : letters) if (rev == p.first) return p.second;
+    for (auto &p : SEVEN_SEG_LETTERS) if (rev == p.pattern) return p.ch;
 
     return '\0';
   }
@@ -254,6 +575,9 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
 
     // Initialize auto-refresh timer to avoid an immediate forced press on boot
     last_set_sent_time_ms = esphome::millis();
+    // Give the bus one stall timeout after boot before declaring it stalled
+    last_valid_frame_ms_ = esphome::millis();
+    state_entered_ms_ = esphome::millis();
 
     // Ensure COOL button pin is setup as an output (harmless if balboa_custom also configures it)
     gpio_set_direction((gpio_num_t)PIN_WRITE_BTN2, GPIO_MODE_OUTPUT);
@@ -265,6 +589,7 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
       ESP_LOGI(TAG, "Boot: auto-pressing COOL to initialize set temp");
       gpio_set_level((gpio_num_t)PIN_WRITE_BTN2, 1);
       last_set_sent_time_ms = esphome::millis();
+      note_temp_press();
     });
     this->set_timeout("boot_press_cool_off", 5200, []() {
       gpio_set_level((gpio_num_t)PIN_WRITE_BTN2, 0);
@@ -291,19 +616,97 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
       last_frame_valid = false;
     }
     portEXIT_CRITICAL(&spinlock_);
+    total_partial_frames_ += partials;
+    uint32_t glitches = glitch_count_;  // single aligned word; read without the lock
+    if (glitches != last_reported_glitches_ && (now - last_glitch_log_ms_) >= GLITCH_LOG_MS) {
+      ESP_LOGW(TAG, "Rejected %u clock glitches (total %u, min edge spacing %uus)",
+               static_cast<unsigned>(glitches - last_reported_glitches_), static_cast<unsigned>(glitches),
+               static_cast<unsigned>(glitch_filter_cycles_ / CYCLES_PER_US));
+      last_reported_glitches_ = glitches;
+      last_glitch_log_ms_ = now;
+    }
     if (partials > 0) {
-      ESP_LOGW(TAG, "Dropped %u partial/incomplete frames (gaps before 21 bits)", partials);
+      ESP_LOGW(TAG, "Dropped %u partial/incomplete frames (gaps before %u bits)", partials,
+               static_cast<unsigned>(Protocol::MIN_FRAME_BITS));
+    }
+
+    // Forward captured frames to stream subscribers (no-op unless stream_port is configured)
+    if (stream_port_ != 0) stream_service_(now);
+
+    // Watchdog: no valid frame for stall_timeout_ms_ -> entities unknown
+    if (!bus_stalled() && (now - last_valid_frame_ms_) >= stall_timeout_ms_) {
+      enter_bus_stall_(now);
+    }
+
+    if (press_pending_ && (now - press_pending_since_ms_) >= PRESS_CONFIRM_TIMEOUT_MS) {
+      press_pending_ = false;
+      press_latency_missed_++;
+      ESP_LOGW(TAG, "Press not confirmed within %ums (missed=%u)", static_cast<unsigned>(PRESS_CONFIRM_TIMEOUT_MS),
+               static_cast<unsigned>(press_latency_missed_));
+    }
+
+    if (now - last_state_stats_log_ms_ >= STATE_STATS_LOG_MS) {
+      last_state_stats_log_ms_ = now;
+      log_display_stats_();
+    }
+
+    // Take the new frame before the resync snapshot: when loop() runs late, a frame and the
+    // snapshot of the span it came from can both be pending
+    bool new_frame = false;
+    uint32_t value = 0;
+    uint8_t  nbits = 0;
+    portENTER_CRITICAL(&spinlock_);
+    if (frame_ready) {
+      value = completed_frame;
+      nbits = completed_bits;
+      frame_ready = false;
+      new_frame = true;
+    }
+    portEXIT_CRITICAL(&spinlock_);
+
+    // A full-length frame that fails the checksums may be the first FRAME_BITS bits of an
+    // over-long span (an extra clock edge). It is held back until its trailing gap has arrived,
+    // which is before the next frame: if the ISR snapshotted the span, the span accounts for it;
+    // otherwise it is reported as an ordinary checksum failure.
+    bool have_frame = new_frame;
+    bool frame_failed = new_frame && nbits == Protocol::FRAME_BITS && !full_frame_ok_(value);
+
+    // A misaligned frame was captured since the last check: take its span from the bit history
+    if (resync_ready_) {
+      uint32_t delivered = take_resync_span_(now);
+      if (held_failure_ && held_failure_value_ == delivered) {
+        held_failure_ = false;
+      } else if (frame_failed && value == delivered) {
+        frame_failed = false;
+        have_frame = false;
+      }
+    }
+    // A span no rule resolved waits for the next frame as context; any later frame ends the wait
+    if (span_pending_) {
+      bool next_ok = have_frame && !frame_failed && nbits == Protocol::FRAME_BITS;
+      resolve_span_(next_ok ? &value : nullptr, have_frame, now);
+    }
+    // A new frame means the gap after a held-back frame passed without a snapshot
+    if (new_frame) report_held_failure_(now);
+    if (frame_failed) {
+      held_failure_ = true;
+      held_failure_value_ = value;
+      have_frame = false;
     }
 
     // If no new frame, allow heartbeat publishes of last known value (only if last frame was valid)
-    if (!frame_ready) {
-      bool heartbeat_due = (now - last_publish_time >= HEARTBEAT_MS);
+    if (!new_frame) {
+      // While stalled there is nothing fresh to heartbeat and no point pressing buttons
+      if (bus_stalled()) return;
+
+      bool heartbeat_due = (heartbeat_ms_ != 0 && now - last_publish_time >= heartbeat_ms_);
 
       // If the set-temp hasn't been captured for a while, force a 'cool' press to make the tub show/publish it
       if ((now - last_set_sent_time_ms) >= SET_FORCE_INTERVAL_MS) {
         ESP_LOGI(TAG, "No set-temp captured for %ums — auto-pressing COOL to refresh set temp", static_cast<unsigned>(now - last_set_sent_time_ms));
         // Activate the physical COOL press (use balboa pin macro)
         gpio_set_level((gpio_num_t)PIN_WRITE_BTN2, 1);
+        note_temp_press();
         // Ensure we release it after a short duration (mirror existing press timing)
         this->set_timeout("auto_press_cool", 200, [](){ gpio_set_level((gpio_num_t)PIN_WRITE_BTN2, 0); });
         // Press Lights 1s after Cool press to also capture the current heating mode
@@ -324,12 +727,7 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
 
       if (!lfv) {
         // No valid stored frame — still publish any known stored values (measured/set/binary) so HA sees activity
-        if (measured_temp_sensor_ && last_measured_temp >= 0) measured_temp_sensor_->publish_state(static_cast<float>(last_measured_temp));
-        if (set_temp_sensor_ && last_set_temp >= 0) set_temp_sensor_->publish_state(static_cast<float>(last_set_temp));
-        if (heater_sensor_ && last_heater >= 0) { heater_sensor_->publish_state(static_cast<bool>(last_heater)); }
-        if (seen_p4_ && pump_sensor_ && last_pump >= 0) { pump_sensor_->publish_state(static_cast<bool>(last_pump)); }
-        if (seen_p4_ && light_sensor_ && last_light >= 0) { light_sensor_->publish_state(static_cast<bool>(last_light)); }
-        if (spa_mode_text_sensor_ && !last_mode_.empty()) { spa_mode_text_sensor_->publish_state(last_mode_); }
+        publish_snapshot_();
 
         ESP_LOGI(TAG, "Heartbeat publish (stored): measured=%d set=%d heater=%d pump=%d light=%d mode=%s", last_measured_temp, last_set_temp, last_heater, last_pump, last_light, last_mode_.c_str());
 
@@ -337,36 +735,26 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
         return;
       }
 
-      uint32_t out   = last_published_value;
       uint8_t  hbits = last_published_bits;
-
-      uint8_t p1 = (out >> (hbits - 7))  & 0x7F;
-      uint8_t p2 = (out >> (hbits - 14)) & 0x7F;
-      uint8_t p3 = (out >> (hbits - 21)) & 0x7F;
-      uint8_t p4 = (hbits >= 24) ? ((out >> (hbits - 24)) & 0x7) : 0;
+      FrameFields hf = Frame::split(last_published_value, hbits);
+      uint8_t p1 = hf.p1, p2 = hf.p2, p3 = hf.p3, p4 = hf.p4;
 
       // Validate exactly like new frames
-      const uint8_t checksum_mask = 0x4B;
-      const uint8_t checksum_val  = 0x00;
-      if ((p1 & checksum_mask) != checksum_val ||
-          (hbits >= 24 && (p4 & 0x1) != 0)) {
-        ESP_LOGW(TAG, "Heartbeat: stored frame fails checksum (p1 masked=0x%02X, p4_lsb=0x%X, hbits=%u), not publishing",
-                static_cast<unsigned>(p1 & checksum_mask), static_cast<unsigned>(p4 & 0x1), static_cast<unsigned>(hbits));
+      if (!Frame::p1_ok(hf) || !Frame::p4_ok(hf)) {
+        ESP_LOGW(TAG, "Heartbeat: stored frame fails checksum (p1 masked=0x%02X, p4 masked=0x%X, hbits=%u), not publishing",
+                static_cast<unsigned>(p1 & Protocol::P1_CHECK_MASK), static_cast<unsigned>(p4 & Protocol::P4_CHECK_MASK), static_cast<unsigned>(hbits));
         return;
       }
 
-      uint8_t seg_b = (p1 >> 5) & 0x1;
-      uint8_t seg_c = (p1 >> 4) & 0x1;
       int8_t digit2 = decode_7seg(p2);
       int8_t digit3 = decode_7seg(p3);
 
       int16_t temp = decode_temp(p1, digit2, digit3);
 
       // Heartbeat: publish binary sensor states as well
-      // Heater is on bit 2 of p1 (observed from hardware)
-      int heater_val = static_cast<int>((p1 >> 2) & 0x1);
-      int pump_val = static_cast<int>((p4 >> 2) & 0x1);
-      int light_val = static_cast<int>((p4 >> 1) & 0x1);
+      int heater_val = Frame::heater(hf);
+      int pump_val = Frame::pump(hf);
+      int light_val = Frame::light(hf);
 
       // Log at info level so this appears even when debug is off
       ESP_LOGI(TAG, "Heartbeat publish: temp=%d set=%d status=0x%X heater=%d pump=%d light=%d", temp, last_set_temp, static_cast<unsigned>(p4), heater_val, pump_val, light_val);
@@ -377,83 +765,63 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
       if (pump_sensor_) { last_pump = pump_val; if (seen_p4_) pump_sensor_->publish_state(static_cast<bool>(pump_val)); }
       if (light_sensor_) { last_light = light_val; if (seen_p4_) light_sensor_->publish_state(static_cast<bool>(light_val)); }
 
-      // Decode char patterns for mode/error detection
-      char c2_hb = decode_7seg_char(p2);
-      char c3_hb = decode_7seg_char(p3);
-      bool is_mode_hb = (c2_hb == 'S' && c3_hb == 't') ||
-                        (c2_hb == 'E' && c3_hb == 'c') ||
-                        (c2_hb == 'S' && c3_hb == 'L');
-
-      // Publish mode heartbeat
+      // Publish mode and error heartbeat from the cached values. The stored frame may be minutes
+      // old, so it must not drive error detection or the display state machine (live frames only).
       if (spa_mode_text_sensor_ && !last_mode_.empty()) { spa_mode_text_sensor_->publish_state(last_mode_); }
-
-      // If p2/p3 form a valid temperature or mode string, clear any previous error and skip error processing
-      if (temp >= 0 || is_mode_hb) {
-        if (!last_error_code_.empty()) {
-          if (error_text_sensor_) error_text_sensor_->publish_state("");
-          last_error_code_.clear(); candidate_error.clear(); stable_error = 0;
-        }
-      } else if (error_text_sensor_) {
-        std::string code = "";
-        code.push_back(c2_hb != '\0' ? c2_hb : '?');
-        code.push_back(c3_hb != '\0' ? c3_hb : '?');
-        const char *trans = translate_error_code(code);
-
-        // Treat any decoded (non-blank) character sequence as a candidate error, or a known translation
-        if (trans != nullptr || (c2_hb != '\0' || c3_hb != '\0')) {
-          if (candidate_error == code) { if (stable_error < 255) stable_error++; } else { candidate_error = code; stable_error = 1; }
-          if (stable_error >= ERROR_STABLE_THRESHOLD && code != last_error_code_) {
-            if (trans) error_text_sensor_->publish_state(code + std::string(" - ") + trans);
-            else error_text_sensor_->publish_state(code);
-            last_error_code_ = code;
-          }
-        } else {
-          // Not an error -> reset candidate
-          candidate_error.clear(); stable_error = 0;
-        }
-      }
+      if (error_text_sensor_) error_text_sensor_->publish_state(format_error_(last_error_code_));
 
       last_publish_time = now;
       first_publish = false;
       return;
     }
 
-    // Copy shared data under spinlock to avoid races with ISR
-    portENTER_CRITICAL(&spinlock_);
-    uint32_t value = completed_frame;
-    uint8_t  nbits = completed_bits;
-    frame_ready = false;
-    portEXIT_CRITICAL(&spinlock_);
+    if (have_frame) process_frame_(value, nbits, now);
+  }
 
-    // Decode the frame: p1/p2/p3 are the top 21 bits (3 × 7-bit segments);
-    // p4 (status bits) only exists when nbits >= 24.
-    uint8_t p1 = (value >> (nbits - 7))  & 0x7F;
-    uint8_t p2 = (value >> (nbits - 14)) & 0x7F;
-    uint8_t p3 = (value >> (nbits - 21)) & 0x7F;
-    uint8_t p4 = (nbits >= 24) ? ((value >> (nbits - 24)) & 0x7) : 0;
+  // A held-back frame whose span was not resynced: validate it as usual (logs the failure and
+  // invalidates the stored frame)
+  void report_held_failure_(uint32_t now) {
+    if (!held_failure_) return;
+    held_failure_ = false;
+    process_frame_(held_failure_value_, Protocol::FRAME_BITS, now);
+  }
+
+  // Decode, validate and publish one frame. Returns false if it fails the checksums.
+  bool process_frame_(uint32_t value, uint8_t nbits, uint32_t now) {
+    // Decode the frame: p1/p2/p3 are the top 3 segment fields;
+    // p4 (status bits) only exists when the frame carries Protocol::FRAME_BITS.
+    FrameFields f = Frame::split(value, nbits);
+    uint8_t p1 = f.p1, p2 = f.p2, p3 = f.p3, p4 = f.p4;
 
     // Verify p1 checksum (always applied)
-    const uint8_t checksum_mask = 0x4B;  // 0b1001011 (mask bits 6,3,1,0 of p1)
-    const uint8_t checksum_val  = 0x00;
-    if ((p1 & checksum_mask) != checksum_val) {
+    if (!Frame::p1_ok(f)) {
       ESP_LOGW(TAG, "Frame fails p1 checksum (p1 masked=0x%02X expected=0x%02X, nbits=%u), ignoring",
-                static_cast<unsigned>(p1 & checksum_mask), static_cast<unsigned>(checksum_val), static_cast<unsigned>(nbits));
+                static_cast<unsigned>(p1 & Protocol::P1_CHECK_MASK), static_cast<unsigned>(Protocol::P1_CHECK_VALUE), static_cast<unsigned>(nbits));
       last_frame_valid = false;
-      return;
+      return false;
     }
-    // p4 LSB checksum only applies when the frame is long enough to include p4
-    if (nbits >= 24 && (p4 & 0x1) != 0) {
-      ESP_LOGW(TAG, "Frame fails p4 checksum (p4_lsb=0x%X, nbits=%u), ignoring",
-                static_cast<unsigned>(p4 & 0x1), static_cast<unsigned>(nbits));
+    // p4 checksum only applies when the frame is long enough to include p4
+    if (!Frame::p4_ok(f)) {
+      ESP_LOGW(TAG, "Frame fails p4 checksum (p4 masked=0x%X, nbits=%u), ignoring",
+                static_cast<unsigned>(p4 & Protocol::P4_CHECK_MASK), static_cast<unsigned>(nbits));
       last_frame_valid = false;
-      return;
+      return false;
     }
 
+    // Frame is valid: feed the bus watchdog (recovers from a stall on the first good frame)
+    last_valid_frame_ms_ = now;
+    if (f.has_status) {
+      last_good_frame_ = value;  // resync context
+      have_last_good_frame_ = true;
+    }
+    valid_frame_count_++;
+    if (bus_stalled() || !bus_state_reported_) exit_bus_stall_(now);
+
     // Small debug: log raw frame and parts
     ESP_LOGD(TAG, "Frame received raw=0x%06X bits=%u p1=0x%02X p2=0x%02X p3=0x%02X p4=0x%X", value, static_cast<unsigned>(nbits), static_cast<unsigned>(p1), static_cast<unsigned>(p2), static_cast<unsigned>(p3), static_cast<unsigned>(p4));
 
     // Mark that we've seen a valid p4 frame (enables pump/light publishing)
-    if (nbits >= 24) seen_p4_ = true;
+    if (f.has_status) seen_p4_ = true;
 
     // Decode the 7-seg patterns to digits
     int8_t digit2 = decode_7seg(p2);
@@ -507,25 +875,15 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
 
       if (!mode_str.empty()) {
         if (candidate_mode_ == mode_str) { if (stable_mode_ < 255) stable_mode_++; }
-        else                             { candidate_mode_ = mode_str; stable_mode_ = 1; }
+        else                             { candidate_mode_ = mode_str; stable_mode_ = 1; candidate_mode_since_ms_ = now; }
+
+        // A Light press is confirmed by a mode string that appeared after it
+        if (stable_mode_ == MODE_STABLE_THRESHOLD && after_press_(candidate_mode_since_ms_)) confirm_press_(now, true, "mode");
 
         if (stable_mode_ >= MODE_STABLE_THRESHOLD && mode_str != last_mode_) {
           last_mode_ = mode_str;
           if (spa_mode_text_sensor_) spa_mode_text_sensor_->publish_state(last_mode_);
           ESP_LOGI(TAG, "Spa mode published: %s", last_mode_.c_str());
-
-          // Mode appearing means Light was pressed, ending the set-temp flash sequence.
-          // If we have a recent set temp potential, confirm and publish it now.
-          if (in_set_mode && set_temp_potential >= 0 && set_temp_potential != last_set_temp
-              && (now - last_candidate_temp_time <= 3000)) {
-            last_set_temp = set_temp_potential;
-            if (set_temp_sensor_) {
-              set_temp_sensor_->publish_state(static_cast<float>(last_set_temp));
-              ESP_LOGD(TAG, "Publishing set temp: %d [confirmed by mode string]", last_set_temp);
-            }
-            last_set_sent_time_ms = now;
-            last_publish_time = now;
-          }
         }
       }
     } else if (!is_set_indicator) {
@@ -534,30 +892,8 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
     }
 
     // Decode/publish any error-code text (p2/p3) but only after it is stable and looks like an error
-    if (error_text_sensor_) {
-      // If temperature or mode string — not an error
-      if (temp >= 0 || is_mode_string) {
-        candidate_error.clear(); stable_error = 0;
-      } else {
-        std::string code = "";
-        code.push_back(c2_char != '\0' ? c2_char : '?');
-        code.push_back(c3_char != '\0' ? c3_char : '?');
-        const char *trans = translate_error_code(code);
-
-        // Treat any decoded (non-blank) character sequence as a candidate error, or a known translation
-        if (trans != nullptr || (c2_char != '\0' || c3_char != '\0')) {
-          if (candidate_error == code) { if (stable_error < 255) stable_error++; } else { candidate_error = code; stable_error = 1; }
-          if (stable_error >= ERROR_STABLE_THRESHOLD && code != last_error_code_) {
-            if (trans) error_text_sensor_->publish_state(code + std::string(" - ") + trans);
-            else error_text_sensor_->publish_state(code);
-            last_error_code_ = code;
-          }
-        } else {
-          // Not an error -> reset candidate tracking
-          candidate_error.clear(); stable_error = 0;
-        }
-      }
-    }
+    // (a temperature or mode string is never an error)
+    bool error_stable = update_error_display_(c2_char, c3_char, temp >= 0 || is_mode_string);
 
     // Stability update for temperature
     if (candidate_temp == temp) {
@@ -565,113 +901,23 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
     } else {
       candidate_temp = temp;
       stable_temp = 1;
+      candidate_temp_since_ms_ = now;
     }
 
-    // Record when we last saw a candidate temperature (even if transient)
-    if (candidate_temp >= 0) {
-      last_candidate_temp_time = now;
-    }
-
-    // Check if we should commit stable values
-    bool zero_stable = (stable_zero >= STABLE_THRESHOLD);
-    bool temp_stable = (stable_temp >= STABLE_THRESHOLD);
-
-    // Set mode logic: detect set-indicator alternation (blank 0x00 OR mode string)
-    if (zero_stable && candidate_is_zero) {
-      // We just saw a stable set indicator - update last_zero_seen_time
-      last_zero_seen_time = now;
-
-      // If we saw a recent candidate temp (even just-before the zero), accept it as potential
-      if (set_temp_potential < 0 && candidate_temp >= 0 && (now - last_candidate_temp_time <= 3000)) {
-        set_temp_potential = candidate_temp; // raw numeric from display
-        ESP_LOGD(TAG, "Zero detected and recent candidate found: set_temp_potential=%d (age=%ums)", set_temp_potential, static_cast<unsigned>(now - last_candidate_temp_time));
-      }
-      in_set_mode = true;
-      // Cancel any pending measured-temp publish because set mode is starting
-      pending_measured_temp = -1;
-      pending_measured_since = 0;
-      ESP_LOGD(TAG, "Zero detected (0x00), entering/staying in set mode");
-    } else if (candidate_temp >= 0 && in_set_mode) {
-      // We have observed a non-zero temp while already in set mode. Set as potential immediately
-      int16_t display_candidate = candidate_temp; // raw numeric from display
-      if (set_temp_potential != display_candidate) {
-        set_temp_potential = display_candidate;
-        last_candidate_temp_time = now;
-        ESP_LOGD(TAG, "Set temp potential updated (transient): %d", set_temp_potential);
-      } else {
-        // refresh timestamp even if same potential
-        last_candidate_temp_time = now;
-      }
-    }
-
-    // Check if we should exit set mode (no zeros for 5 seconds)
-    if (in_set_mode && (now - last_zero_seen_time >= SET_MODE_TIMEOUT_MS)) {
-      in_set_mode = false;
-      set_temp_potential = -1;
-      ESP_LOGD(TAG, "Exited set mode (timeout)");
-    }
-
-    // Publish set temp if we have a potential and see another set indicator (blank or mode string)
-    if (zero_stable && candidate_is_zero && set_temp_potential >= 0 && set_temp_potential != last_set_temp) {
-      // Optional safety: ensure the candidate temp was seen recently (within 3s) to avoid stale data
-      if (now - last_candidate_temp_time <= 3000) {
-        last_set_temp = set_temp_potential;
-        if (set_temp_sensor_) {
-          set_temp_sensor_->publish_state(static_cast<float>(last_set_temp));
-          ESP_LOGD(TAG, "Publishing set temp: %d [confirmed by zero]", last_set_temp);
-        }
-        // Reset the auto-refresh timer since we successfully captured & published a set temp
-        last_set_sent_time_ms = now;
-        last_publish_time = now;
-      } else {
-        ESP_LOGW(TAG, "Set temp potential too old (%ums), ignoring", static_cast<unsigned>(now - last_candidate_temp_time));
-      }
-    }
-
-    // Publish measured temp, but wait a short time to ensure we are not entering set mode
-    if (temp_stable && candidate_temp >= 0 && candidate_temp != last_measured_temp) {
-      // When a stable numeric temperature is visible, clear any previously-published error code
-      if (last_error_code_ != "") {
-        if (error_text_sensor_) error_text_sensor_->publish_state("");
-        last_error_code_.clear(); candidate_error.clear(); stable_error = 0;
-      }
-      if (in_set_mode) {
-        // If we're in set mode, drop any candidate
-        pending_measured_temp = -1;
-        pending_measured_since = 0;
-      } else {
-        // Not in set mode: start or evaluate pending timer
-        int16_t display_candidate = candidate_temp; // raw numeric from display
-        if (pending_measured_temp != display_candidate) {
-          // New candidate: start pending timer
-          pending_measured_temp = display_candidate;
-          pending_measured_since = now;
-          ESP_LOGD(TAG, "Measured temp candidate %d pending, waiting %ums to ensure not set-mode", display_candidate, static_cast<unsigned>(MEASURE_PUBLISH_DELAY_MS));
-        } else if ((now - pending_measured_since) >= MEASURE_PUBLISH_DELAY_MS) {
-          // Timer elapsed and still not in set mode -> publish
-          last_measured_temp = pending_measured_temp;
-          if (measured_temp_sensor_) {
-            measured_temp_sensor_->publish_state(static_cast<float>(last_measured_temp));
-            ESP_LOGD(TAG, "Publishing measured temp: %d", last_measured_temp);
-          }
-          last_publish_time = now;
-          pending_measured_temp = -1;
-          pending_measured_since = 0;
-        }
-      }
-    } else {
-      // No stable candidate or candidate changed -> clear any pending measured temp
-      if (candidate_temp < 0 || pending_measured_temp != candidate_temp) {
-        pending_measured_temp = -1;
-        pending_measured_since = 0;
-      }
-    }
+    // Everything display-related from here on is the state machine's: one event for what this
+    // frame shows (once stable), then the handling of the resulting state
+    ShownFrame shown;
+    shown.set_indicator = stable_zero >= STABLE_THRESHOLD && candidate_is_zero;
+    shown.mode_shown = shown.set_indicator && is_mode_string && stable_mode_ >= MODE_STABLE_THRESHOLD;
+    shown.error = error_stable;
+    shown.temp = (stable_temp >= STABLE_THRESHOLD) ? candidate_temp : -1;
+    shown.raw_temp = candidate_temp;
+    step_display_(shown, now);
 
     // Always update binary sensors from p4 and p1 with per-bit stability
-    uint8_t p1_bits = p1;
-    int8_t cur_heater = static_cast<int8_t>((p1_bits >> 2) & 0x1);
-    int8_t cur_pump = static_cast<int8_t>((p4 >> 2) & 0x1);
-    int8_t cur_light = static_cast<int8_t>((p4 >> 1) & 0x1);
+    int8_t cur_heater = Frame::heater(f);
+    int8_t cur_pump = Frame::pump(f);
+    int8_t cur_light = Frame::light(f);
 
     // Update heater stability (existing)
     if (candidate_heater == cur_heater) { if (stable_heater < 255) stable_heater++; } else { candidate_heater = cur_heater; stable_heater = 1; }
@@ -719,13 +965,17 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
     int8_t pub_light = light_ok ? candidate_light : last_light;
 
     bool binary_changed = (pub_heater != last_heater || pub_pump != last_pump || pub_light != last_light);
+    bool light_toggled = (last_light >= 0 && pub_light >= 0 && pub_light != last_light);
     if (binary_changed) {
       ESP_LOGD(TAG, "Binary sensors updated: heater=%d pump=%d light=%d (stable: h=%u p=%u l=%u)", pub_heater, pub_pump, pub_light, static_cast<unsigned>(stable_heater), static_cast<unsigned>(stable_pump), static_cast<unsigned>(stable_light));
       if (heater_sensor_) { heater_sensor_->publish_state(static_cast<bool>(pub_heater)); last_heater = pub_heater; }
-      if (pump_sensor_) { last_pump = pub_pump; if (seen_p4_) pump_sensor_->publish_state(static_cast<bool>(pub_pump)); }
-      if (light_sensor_) { last_light = pub_light; if (seen_p4_) light_sensor_->publish_state(static_cast<bool>(pub_light)); }
+      // Pump/light may still be unknown (-1) right after boot or a bus stall; don't publish those as "on"
+      if (pump_sensor_) { last_pump = pub_pump; if (seen_p4_ && pub_pump >= 0) pump_sensor_->publish_state(static_cast<bool>(pub_pump)); }
+      if (light_sensor_) { last_light = pub_light; if (seen_p4_ && pub_light >= 0) light_sensor_->publish_state(static_cast<bool>(pub_light)); }
       
       ESP_LOGD(TAG, "Binary sensors updated: heater=%d pump=%d light=%d", pub_heater, pub_pump, pub_light);
+      // Light pressed outside set mode toggles the light instead of showing the mode
+      if (light_toggled) confirm_press_(now, true, "light");
 
       last_published_value = value;
       last_published_bits  = nbits;
@@ -738,9 +988,436 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
       // No change; do not publish
       ESP_LOGD(TAG, "No changes detected");
     }
+    return true;
+  }
+
+  // A full-length frame passes both checksums
+  static bool full_frame_ok_(uint32_t value) {
+    FrameFields f = Frame::split(value, Protocol::FRAME_BITS);
+    return Frame::p1_ok(f) && Frame::p4_ok(f);
+  }
+
+  // A full frame recovered from the bit history must pass both checksums and show valid glyphs
+  static bool plausible_frame_(uint32_t value) {
+    if (!full_frame_ok_(value)) return false;
+    FrameFields f = Frame::split(value, Protocol::FRAME_BITS);
+    for (uint8_t seg : {f.p2, f.p3}) {
+      if (seg != 0x00 && decode_7seg(seg) < 0 && decode_7seg_char(seg) == '\0') return false;
+    }
+    return true;
   }
 
+  // How resync_pick() chose the frame of an over-long span
+  enum class ResyncPick : uint8_t { NONE, CONTEXT, UNIQUE, DUPLICATE };
+  static const char *resync_pick_name(ResyncPick p) {
+    switch (p) {
+      case ResyncPick::CONTEXT:   return "context";
+      case ResyncPick::UNIQUE:    return "unique";
+      case ResyncPick::DUPLICATE: return "duplicate bit";
+      default:                    return "none";
+    }
+  }
 
+  // Sliding-window resynchronisation. The ISR snapshots its bit history whenever more than
+  // FRAME_BITS bits arrived between two gaps (an extra bit from a glitch, or noise before the
+  // frame). The frame normally ends at the gap, so candidate alignments are:
+  //   - every FRAME_BITS window inside the snapshot (offset 0 = the bits just before the gap)
+  //   - with exactly one extra bit, the span with any single bit removed
+  // Only plausible candidates count. Most spans have several, so they are ranked:
+  //   1. one matching the last accepted frame or the next frame (the display rarely changes)
+  //   2. all plausible candidates agree
+  //   3. with one extra bit, all candidates that remove a bit equal to its neighbour agree: an
+  //      extra clock edge samples the data line inside a real bit, so it duplicates a neighbour
+  // last/next may be null. Static and side-effect free so the host benches can drive it.
+  static ResyncPick resync_pick(uint64_t hist, uint8_t hbits, const uint32_t *last, const uint32_t *next,
+                                uint32_t &out) {
+    constexpr uint8_t N = Protocol::FRAME_BITS;
+    constexpr uint32_t MASK = (1u << N) - 1;
+
+    struct Pick {
+      bool found = false, ambiguous = false;
+      uint32_t value = 0;
+      void add(uint32_t cand) {
+        if (found && cand != value) ambiguous = true;
+        value = cand;
+        found = true;
+      }
+      bool unique() const { return found && !ambiguous; }
+    } context, any, duplicate;
+
+    auto consider = [&](uint32_t cand, bool dup) {
+      if (!plausible_frame_(cand)) return;
+      any.add(cand);
+      if (dup) duplicate.add(cand);
+      if ((last && cand == *last) || (next && cand == *next)) context.add(cand);
+    };
+
+    if (hbits == N + 1) {
+      // k = N and k = 0 are the two offset windows
+      uint32_t span = static_cast<uint32_t>(hist) & ((MASK << 1) | 1);
+      for (uint8_t k = 0; k <= N; ++k) {
+        uint32_t bit = (span >> k) & 1;
+        bool dup = (k > 0 && ((span >> (k - 1)) & 1) == bit) || (k < N && ((span >> (k + 1)) & 1) == bit);
+        uint32_t low = span & ((1u << k) - 1);
+        consider(((span >> (k + 1)) << k) | low, dup);
+      }
+    } else {
+      for (uint8_t off = 0; off + N <= hbits; ++off) consider(static_cast<uint32_t>(hist >> off) & MASK, false);
+    }
+
+    if (context.unique()) { out = context.value; return ResyncPick::CONTEXT; }
+    if (any.unique())     { out = any.value;     return ResyncPick::UNIQUE; }
+    if (duplicate.unique()) { out = duplicate.value; return ResyncPick::DUPLICATE; }
+    return ResyncPick::NONE;
+  }
+
+  // Take the ISR's resync snapshot. Returns the first FRAME_BITS bits of the span, which the ISR
+  // already delivered as a frame. If those pass the checksums the extra bits were a harmless
+  // tail; otherwise the span is kept for resolve_span_().
+  uint32_t take_resync_span_(uint32_t now) {
+    portENTER_CRITICAL(&spinlock_);
+    uint64_t hist = resync_history_;
+    uint8_t  hbits = resync_bits_;
+    resync_ready_ = false;
+    portEXIT_CRITICAL(&spinlock_);
+
+    constexpr uint8_t N = Protocol::FRAME_BITS;
+    uint32_t delivered = static_cast<uint32_t>(hist >> (hbits - N)) & ((1u << N) - 1);
+    if (full_frame_ok_(delivered)) return delivered;
+    if (span_pending_) resolve_span_(nullptr, true, now);  // no next frame came between the two
+    span_history_ = hist;
+    span_bits_ = hbits;
+    span_pending_ = true;
+    return delivered;
+  }
+
+  // Pick the frame of the pending span. Until a later frame has arrived (final) only a unique
+  // candidate is taken: the last frame alone would favour the old value across a display change,
+  // so the span waits for the next frame as context. Once final, an unresolved span is lost.
+  void resolve_span_(const uint32_t *next, bool final, uint32_t now) {
+    uint32_t frame = 0;
+    ResyncPick pick = resync_pick(span_history_, span_bits_, have_last_good_frame_ ? &last_good_frame_ : nullptr,
+                                  next, frame);
+    if (pick != ResyncPick::UNIQUE && !final) return;
+    span_pending_ = false;
+
+    if (pick != ResyncPick::NONE) {
+      resync_recovered_++;
+      ESP_LOGD(TAG, "Resync: recovered frame 0x%06X from %u-bit window by %s (recovered=%u failed=%u)",
+               static_cast<unsigned>(frame), static_cast<unsigned>(span_bits_), resync_pick_name(pick),
+               static_cast<unsigned>(resync_recovered_), static_cast<unsigned>(resync_failed_));
+      process_frame_(frame, Protocol::FRAME_BITS, now);
+      return;
+    }
+    resync_failed_++;
+    portENTER_CRITICAL(&spinlock_);
+    last_frame_valid = false;  // the frame in this span is lost
+    portEXIT_CRITICAL(&spinlock_);
+    ESP_LOGW(TAG, "Resync: no unambiguous alignment in %u-bit window (recovered=%u failed=%u)",
+             static_cast<unsigned>(span_bits_), static_cast<unsigned>(resync_recovered_),
+             static_cast<unsigned>(resync_failed_));
+  }
+
+
+
+  // Publish every known cached value in one batch; returns the number of entities published.
+  // While the bus is stalled only the bus state is known.
+  uint8_t publish_snapshot_() {
+    uint8_t n = 0;
+    if (bus_state_text_sensor_ && bus_state_reported_) {
+      bus_state_text_sensor_->publish_state(bus_stalled() ? "stalled" : "ok"); n++;
+    }
+    if (bus_stalled()) return n;
+    if (measured_temp_sensor_ && last_measured_temp >= 0) { measured_temp_sensor_->publish_state(static_cast<float>(last_measured_temp)); n++; }
+    if (set_temp_sensor_ && last_set_temp >= 0) { set_temp_sensor_->publish_state(static_cast<float>(last_set_temp)); n++; }
+    if (heater_sensor_ && last_heater >= 0) { heater_sensor_->publish_state(static_cast<bool>(last_heater)); n++; }
+    if (seen_p4_ && pump_sensor_ && last_pump >= 0) { pump_sensor_->publish_state(static_cast<bool>(last_pump)); n++; }
+    if (seen_p4_ && light_sensor_ && last_light >= 0) { light_sensor_->publish_state(static_cast<bool>(last_light)); n++; }
+    if (spa_mode_text_sensor_ && !last_mode_.empty()) { spa_mode_text_sensor_->publish_state(last_mode_); n++; }
+    if (error_text_sensor_ && bus_state_reported_) { error_text_sensor_->publish_state(format_error_(last_error_code_)); n++; }
+    return n;
+  }
+
+  // Error text as published: the 2-character code plus its translation when known
+  static std::string format_error_(const std::string &code) {
+    if (code.empty()) return code;
+    const char *trans = translate_error_code(code);
+    return trans ? code + std::string(" - ") + trans : code;
+  }
+
+  // What one valid frame shows, after debouncing; the input of step_display_()
+  struct ShownFrame {
+    bool set_indicator;  // stable blank or mode string
+    bool mode_shown;     // the set indicator is a stable mode string
+    bool error;          // stable error code
+    int16_t temp;        // stable temperature, -1 if none
+    int16_t raw_temp;    // this frame's temperature even if not yet stable, -1 if none
+  };
+
+  // Run the display state machine for one valid frame: fire the event for what the frame shows
+  // (at most one; the kinds are mutually exclusive) and the state's timeout, then run the handling
+  // of the resulting state. Bus stall and recovery come from the watchdog (enter/exit_bus_stall_).
+  void step_display_(const ShownFrame &s, uint32_t now) {
+    if (s.set_indicator) {
+      state_refreshed_ms_ = now;
+      fire_display_event_(s.mode_shown ? DisplayEvent::MODE_STRING : DisplayEvent::SET_INDICATOR, now);
+      ESP_LOGD(TAG, "Set indicator detected, in %s", display_state_name(display_state_));
+    } else if (s.error) {
+      fire_display_event_(DisplayEvent::ERROR_SHOWN, now);
+    } else if (s.temp >= 0) {
+      fire_display_event_(DisplayEvent::TEMP_SHOWN, now);
+      clear_error_();  // a visible temperature means no error code is shown
+    }
+
+    uint32_t state_timeout = DISPLAY_STATE_TIMEOUT_MS[static_cast<size_t>(display_state_)];
+    if (state_timeout != 0 && (now - state_refreshed_ms_ >= state_timeout)) {
+      fire_display_event_(DisplayEvent::SET_TIMEOUT, now);
+      ESP_LOGD(TAG, "Exited set mode (timeout)");
+    }
+
+    switch (display_state_) {
+      case DisplayState::NORMAL:     handle_normal_(s, now); break;
+      case DisplayState::SET_FLASH:
+      case DisplayState::MODE_SHOWN: handle_set_mode_(s, now); break;
+      default:                       break;  // ERROR: published by update_error_display_; STALLED: nothing shown
+    }
+  }
+
+  // NORMAL: publish a new measured temperature once it has been on show for
+  // MEASURE_PUBLISH_DELAY_MS, counted from both its first frame and entering NORMAL
+  void handle_normal_(const ShownFrame &s, uint32_t now) {
+    if (s.temp < 0 || s.temp == last_measured_temp) return;
+    if (now - candidate_temp_since_ms_ < MEASURE_PUBLISH_DELAY_MS || now - state_entered_ms_ < MEASURE_PUBLISH_DELAY_MS) return;
+    last_measured_temp = s.temp;
+    if (measured_temp_sensor_) {
+      measured_temp_sensor_->publish_state(static_cast<float>(last_measured_temp));
+      ESP_LOGD(TAG, "Publishing measured temp: %d", last_measured_temp);
+    }
+    last_publish_time = now;
+  }
+
+  // SET_FLASH / MODE_SHOWN: digits shown during the flash become the potential set temp; the next
+  // set indicator (blank or mode string) confirms it
+  void handle_set_mode_(const ShownFrame &s, uint32_t now) {
+    if (s.raw_temp >= 0) {
+      set_temp_potential_since_ms_ = candidate_temp_since_ms_;  // latest showing of these digits
+      if (set_temp_potential != s.raw_temp) {
+        set_temp_potential = s.raw_temp;
+        ESP_LOGD(TAG, "Set temp potential updated (transient): %d", set_temp_potential);
+      }
+      last_candidate_temp_time = now;
+      return;
+    }
+    if (!s.set_indicator || set_temp_potential < 0) return;
+    // Optional safety: ensure the candidate temp was seen recently to avoid stale data
+    if (now - last_candidate_temp_time > CANDIDATE_FRESH_MS) {
+      if (set_temp_potential != last_set_temp) {
+        ESP_LOGW(TAG, "Set temp potential too old (%ums), ignoring", static_cast<unsigned>(now - last_candidate_temp_time));
+      }
+      return;
+    }
+    // A fresh set-temp capture confirms a pending Warm/Cool press even when the value is unchanged,
+    // provided the captured digits were shown after the press (not left over from an earlier one)
+    if (after_press_(set_temp_potential_since_ms_)) confirm_press_(now, false, "set temp capture");
+    record_set_capture_(now);
+    if (set_temp_potential != last_set_temp) {
+      publish_set_temp_(now, s.mode_shown ? "confirmed by mode string" : "confirmed by blank");
+    }
+  }
+
+  // Apply an event to the display state machine; returns false if the current state ignores it
+  bool fire_display_event_(DisplayEvent ev, uint32_t now) {
+    for (size_t i = 0; i < NUM_DISPLAY_TRANSITIONS; ++i) {
+      const DisplayTransition &t = DISPLAY_TRANSITIONS[i];
+      if (t.from != display_state_ || t.event != ev) continue;
+
+      uint32_t dwell = now - state_entered_ms_;
+      TransitionStats &st = transition_stats_[i];
+      st.count++;
+      st.last_ms = dwell;
+      st.total_ms += dwell;
+      if (dwell > st.max_ms) st.max_ms = dwell;
+
+      bool was_set_mode = in_set_mode();
+      ESP_LOGD(TAG, "Display %s -> %s after %ums", display_state_name(t.from), display_state_name(t.to),
+               static_cast<unsigned>(dwell));
+      display_state_ = t.to;
+      state_entered_ms_ = now;
+      if (!was_set_mode && in_set_mode()) {
+        set_mode_started_ms_ = now;
+        set_capture_recorded_ = false;
+      } else if (was_set_mode && !in_set_mode()) {
+        set_temp_potential = -1;  // the capture belongs to the set-mode session that just ended
+      }
+      return true;
+    }
+    return false;
+  }
+
+  // Time from entering set mode to the first fresh set-temp capture of that session
+  void record_set_capture_(uint32_t now) {
+    if (set_capture_recorded_ || !in_set_mode()) return;
+    set_capture_recorded_ = true;
+    uint32_t ms = now - set_mode_started_ms_;
+    set_capture_stats_.count++;
+    set_capture_stats_.last_ms = ms;
+    set_capture_stats_.total_ms += ms;
+    if (ms > set_capture_stats_.max_ms) set_capture_stats_.max_ms = ms;
+    ESP_LOGD(TAG, "Set temp captured %ums after entering set mode", static_cast<unsigned>(ms));
+  }
+
+  void log_display_stats_() {
+    ESP_LOGI(TAG, "Display state: %s (set-temp capture n=%u avg=%ums max=%ums)", display_state_name(display_state_),
+             static_cast<unsigned>(set_capture_stats_.count),
+             static_cast<unsigned>(set_capture_stats_.count ? set_capture_stats_.total_ms / set_capture_stats_.count : 0),
+             static_cast<unsigned>(set_capture_stats_.max_ms));
+    for (size_t i = 0; i < NUM_DISPLAY_TRANSITIONS; ++i) {
+      const TransitionStats &st = transition_stats_[i];
+      if (st.count == 0) continue;
+      ESP_LOGI(TAG, "  %s -> %s: n=%u last=%ums avg=%ums max=%ums", display_state_name(DISPLAY_TRANSITIONS[i].from),
+               display_state_name(DISPLAY_TRANSITIONS[i].to), static_cast<unsigned>(st.count),
+               static_cast<unsigned>(st.last_ms), static_cast<unsigned>(st.total_ms / st.count),
+               static_cast<unsigned>(st.max_ms));
+    }
+  }
+
+  // Track error-code candidates from the p2/p3 characters and publish once stable. Returns true
+  // while a stable error code is shown (the ERROR_SHOWN input of step_display_).
+  // display_ok: p2/p3 show a temperature or mode string, so this frame is not an error.
+  // The error state is tracked even without the text sensor so the state machine does not depend on it.
+  bool update_error_display_(char c2, char c3, bool display_ok) {
+    if (display_ok) {
+      candidate_error.clear(); stable_error = 0;
+      return false;
+    }
+    std::string code = "";
+    code.push_back(c2 != '\0' ? c2 : '?');
+    code.push_back(c3 != '\0' ? c3 : '?');
+    const char *trans = translate_error_code(code);
+
+    // Treat any decoded (non-blank) character sequence as a candidate error, or a known translation
+    if (trans != nullptr || (c2 != '\0' || c3 != '\0')) {
+      if (candidate_error == code) { if (stable_error < 255) stable_error++; } else { candidate_error = code; stable_error = 1; }
+      if (stable_error >= ERROR_STABLE_THRESHOLD) {
+        if (code != last_error_code_) {
+          if (error_text_sensor_) error_text_sensor_->publish_state(format_error_(code));
+          last_error_code_ = code;
+        }
+        return true;
+      }
+    } else {
+      // Not an error -> reset candidate tracking
+      candidate_error.clear(); stable_error = 0;
+    }
+    return false;
+  }
+
+  // A temperature is visible again: clear any published error code
+  void clear_error_() {
+    if (last_error_code_.empty()) return;
+    if (error_text_sensor_) error_text_sensor_->publish_state("");
+    last_error_code_.clear(); candidate_error.clear(); stable_error = 0;
+  }
+
+  // Publish the captured set temperature (set_temp_potential); also confirms a pending Warm/Cool press
+  void publish_set_temp_(uint32_t now, const char *why) {
+    last_set_temp = set_temp_potential;
+    if (set_temp_sensor_) {
+      set_temp_sensor_->publish_state(static_cast<float>(last_set_temp));
+      ESP_LOGD(TAG, "Publishing set temp: %d [%s]", last_set_temp, why);
+    }
+    // Reset the auto-refresh timer since we successfully captured & published a set temp
+    last_set_sent_time_ms = now;
+    last_publish_time = now;
+    confirm_press_(now, false, "set temp publish");
+  }
+
+  void start_press_(bool light) {
+    press_pending_ = true;
+    press_is_light_ = light;
+    press_pending_since_ms_ = esphome::millis();
+  }
+
+  // True if something first seen at since_ms appeared at or after the pending press
+  bool after_press_(uint32_t since_ms) const {
+    return press_pending_ && static_cast<int32_t>(since_ms - press_pending_since_ms_) >= 0;
+  }
+
+  // Close a pending press measurement of the given kind and report it
+  void confirm_press_(uint32_t now, bool light, const char *what) {
+    if (!press_pending_ || press_is_light_ != light) return;
+    press_pending_ = false;
+    uint32_t latency = now - press_pending_since_ms_;
+    press_latency_count_++;
+    press_latency_sum_ms_ += latency;
+    if (latency < press_latency_min_ms_) press_latency_min_ms_ = latency;
+    if (latency > press_latency_max_ms_) press_latency_max_ms_ = latency;
+    ESP_LOGI(TAG, "Press confirmed by %s after %ums (n=%u min=%u avg=%u max=%u missed=%u)", what,
+             static_cast<unsigned>(latency), static_cast<unsigned>(press_latency_count_),
+             static_cast<unsigned>(press_latency_min_ms_),
+             static_cast<unsigned>(press_latency_sum_ms_ / press_latency_count_),
+             static_cast<unsigned>(press_latency_max_ms_), static_cast<unsigned>(press_latency_missed_));
+    if (press_latency_sensor_) press_latency_sensor_->publish_state(static_cast<float>(latency));
+  }
+
+  // Bus stalled: set the entities to unknown (NaN / invalidate_state(); the device stays online,
+  // so Home Assistant shows "unknown", not "unavailable") and forget the decoded state so nothing
+  // stale is re-published.
+  // The set temp, spa mode and error code are cached (not forgotten) and restored on recovery.
+  void enter_bus_stall_(uint32_t now) {
+    // No frame is coming to settle a held-back failure or a pending span: report them now. The
+    // span already had the last frame as context, so it can only be counted as failed.
+    report_held_failure_(now);
+    if (span_pending_) resolve_span_(nullptr, true, now);
+    have_last_good_frame_ = false;
+    fire_display_event_(DisplayEvent::BUS_STALL, now);
+    bus_state_reported_ = true;
+    bus_stall_count_++;
+    ESP_LOGW(TAG, "Bus stalled: no valid frame for %ums (stall #%u), setting entities to unknown",
+             static_cast<unsigned>(now - last_valid_frame_ms_), static_cast<unsigned>(bus_stall_count_));
+
+    if (measured_temp_sensor_) measured_temp_sensor_->publish_state(NAN);
+    if (set_temp_sensor_) set_temp_sensor_->publish_state(NAN);
+    if (heater_sensor_) heater_sensor_->invalidate_state();
+    if (pump_sensor_) pump_sensor_->invalidate_state();
+    if (light_sensor_) light_sensor_->invalidate_state();
+    // Text sensors cannot be marked invalid; clear them so no stale mode or error stays on show
+    if (spa_mode_text_sensor_) spa_mode_text_sensor_->publish_state("");
+    if (error_text_sensor_) error_text_sensor_->publish_state("");
+    if (bus_state_text_sensor_) bus_state_text_sensor_->publish_state("stalled");
+
+    last_measured_temp = -1;
+    last_heater = -1; last_pump = -1; last_light = -1;
+    last_heater_off_time = 0;
+    candidate_temp = -2; stable_temp = 0;
+    candidate_is_zero = false; stable_zero = 0;
+    candidate_heater = -2; stable_heater = 0;
+    candidate_pump = -1; stable_pump = 0;
+    candidate_light = -1; stable_light = 0;
+    candidate_error.clear(); stable_error = 0;
+    candidate_mode_.clear(); stable_mode_ = 0;
+    set_temp_potential = -1;
+    press_pending_ = false;
+
+    portENTER_CRITICAL(&spinlock_);
+    last_frame_valid = false;
+    portEXIT_CRITICAL(&spinlock_);
+  }
+
+  // First valid frame after boot or a stall. Live values re-publish through the normal stability
+  // path (their last_* values were reset); cached settings are restored immediately.
+  void exit_bus_stall_(uint32_t now) {
+    bool was_stalled = fire_display_event_(DisplayEvent::BUS_RECOVER, now);
+    bus_state_reported_ = true;
+    if (bus_state_text_sensor_) bus_state_text_sensor_->publish_state("ok");
+    if (!was_stalled) return;
+
+    ESP_LOGI(TAG, "Bus recovered after stall #%u", static_cast<unsigned>(bus_stall_count_));
+    if (set_temp_sensor_ && last_set_temp >= 0) set_temp_sensor_->publish_state(static_cast<float>(last_set_temp));
+    if (spa_mode_text_sensor_ && !last_mode_.empty()) spa_mode_text_sensor_->publish_state(last_mode_);
+    if (error_text_sensor_ && !last_error_code_.empty()) error_text_sensor_->publish_state(format_error_(last_error_code_));
+    last_publish_time = now;
+  }
 
   // Public dispatcher safely callable from C ISR wrapper
   void IRAM_ATTR handle_isr() { this->on_clock_edge_isr(); }
@@ -756,6 +1433,38 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   // Count partial/incomplete frames detected by ISR (incremented when a gap resets a non-24-bit frame)
   volatile uint32_t partial_frame_count = 0;
 
+  // Clock glitch filter: a noise spike on a long CLK line shows up as an extra rising edge and
+  // would shift every following bit of the frame. Edges arriving less than glitch_filter_cycles_
+  // after the last accepted edge are ignored and counted. Spacing is measured from the last
+  // accepted edge, so a spike further into the bit is still taken as an extra bit (left to
+  // resync_pick), and a spike accepted just before a real edge makes the filter reject the real
+  // edge instead. Useful up to about half the clock period; see README (Wiring).
+  uint32_t glitch_filter_cycles_ = 0;        // 0 = filter off
+  volatile uint32_t glitch_count_ = 0;       // cumulative rejected edges (ISR writes, loop reads)
+  uint32_t last_reported_glitches_ = 0;
+  uint32_t last_glitch_log_ms_ = 0;
+  static constexpr uint32_t GLITCH_LOG_MS = 10000;  // rate-limit the glitch warning
+
+  // Bit history for resynchronisation (see resync_pick). Every sampled bit is shifted in, across
+  // frame boundaries; bits_since_gap_ tells how much of it belongs to the current gap-delimited span.
+  uint64_t bit_history_ = 0;
+  uint8_t  bits_since_gap_ = 0;
+  uint64_t resync_history_ = 0;          // snapshot taken at a gap after an over-long span
+  uint8_t  resync_bits_ = 0;             // bits in the span (FRAME_BITS < n <= 64)
+  volatile bool resync_ready_ = false;
+  uint32_t resync_recovered_ = 0;
+  uint32_t resync_failed_ = 0;
+  // Span taken from the snapshot and not yet resolved (see resolve_span_)
+  uint64_t span_history_ = 0;
+  uint8_t  span_bits_ = 0;
+  bool span_pending_ = false;
+  // Last full frame that passed the checksums: context for resync_pick()
+  uint32_t last_good_frame_ = 0;
+  bool have_last_good_frame_ = false;
+  // Full-length frame that failed the checksums, held until its span is known (see loop())
+  bool held_failure_ = false;
+  uint32_t held_failure_value_ = 0;
+
   // CPU frequency assumptions and derived constants for timing
   static constexpr uint32_t CPU_MHZ = 240u;                // ESP32 clock (MHz)
   static constexpr uint32_t CYCLES_PER_US = CPU_MHZ;       // cycles per microsecond
@@ -769,12 +1478,259 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
   // Read cycle counter (IRAM safe)
   static inline uint32_t IRAM_ATTR get_cycle_count() {
     uint32_t ccount;
+#ifdef __XTENSA__
     asm volatile ("rsr.ccount %0" : "=a" (ccount));
+#else
+    ccount = esp32_spa_host_cycle_count();
+#endif
     return ccount;
   }
 
   // Removed C++ static wrapper to avoid relocation/linker issues. A plain C ISR wrapper is defined at global scope.
 
+  // ---- Capture ring (ISR -> stream) ----
+  // Every completed frame is also queued here with its cycle count so loop() can stream frames
+  // that arrive faster than it drains `completed_frame`. Guarded by spinlock_.
+  static constexpr uint8_t CAPTURE_RING_SIZE = 32;
+  uint32_t ring_raw_[CAPTURE_RING_SIZE] = {};
+  uint32_t ring_ccount_[CAPTURE_RING_SIZE] = {};
+  uint8_t  ring_bits_[CAPTURE_RING_SIZE] = {};
+  volatile uint8_t ring_head_ = 0;             // next write slot (ISR)
+  volatile uint8_t ring_tail_ = 0;             // next read slot (loop)
+  volatile uint32_t ring_overruns_ = 0;        // frames dropped because the ring was full
+  volatile uint32_t captured_frame_count_ = 0; // all frames handed over by the ISR
+
+  // Hand a completed frame to loop(). Must be called with spinlock_ held.
+  void IRAM_ATTR complete_frame_isr_(uint32_t raw, uint8_t bits, uint32_t ccount) {
+    completed_frame = raw;
+    completed_bits  = bits;
+    frame_ready     = true;
+    captured_frame_count_++;
+    if (stream_port_ == 0) return;
+    uint8_t next = static_cast<uint8_t>((ring_head_ + 1) % CAPTURE_RING_SIZE);
+    if (next == ring_tail_) { ring_overruns_++; return; }
+    ring_raw_[ring_head_] = raw;
+    ring_bits_[ring_head_] = bits;
+    ring_ccount_[ring_head_] = ccount;
+    ring_head_ = next;
+  }
+
+  // ---- Stream state (loop only) ----
+  struct StreamSubscriber {
+    bool active = false;
+    struct sockaddr_in addr{};
+    uint32_t last_seen_ms = 0;
+    uint8_t  consecutive_failures = 0;
+    uint32_t dropped_packets = 0;
+  };
+  int stream_sock_ = -1;
+  uint32_t stream_last_open_attempt_ms_ = 0;
+  StreamSubscriber stream_subs_[STREAM_MAX_SUBSCRIBERS];
+  uint8_t  stream_batch_[STREAM_HEADER_SIZE + STREAM_BATCH_FRAMES * STREAM_ENTRY_SIZE] = {};
+  uint8_t  stream_batch_count_ = 0;
+  uint32_t stream_batch_started_ms_ = 0;
+  uint16_t stream_seq_ = 0;
+  uint32_t stream_packets_sent_ = 0;
+  uint32_t stream_send_drops_ = 0;          // packets not delivered to a subscriber (all subscribers)
+  uint32_t stream_rejected_subscribers_ = 0;
+  uint32_t stream_bad_token_ = 0;           // datagrams ignored for a missing/wrong token
+  uint32_t stream_last_stats_ms_ = 0;
+  uint32_t total_partial_frames_ = 0;       // cumulative copy of partial_frame_count for the stream header
+
+  void stream_open_(uint32_t now) {
+    if (now - stream_last_open_attempt_ms_ < STREAM_REOPEN_MS && stream_last_open_attempt_ms_ != 0) return;
+    stream_last_open_attempt_ms_ = now;
+    if (!esphome::network::is_connected()) return;
+    if (stream_token_.empty()) ESP_LOGW(TAG, "Stream: no stream_token set, every subscription will be rejected");
+
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) {
+      ESP_LOGW(TAG, "Stream: socket() failed (errno=%d)", errno);
+      return;
+    }
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(stream_port_);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+      ESP_LOGW(TAG, "Stream: bind to UDP port %u failed (errno=%d)", static_cast<unsigned>(stream_port_), errno);
+      close(sock);
+      return;
+    }
+    stream_sock_ = sock;
+    ESP_LOGI(TAG, "Stream: listening on UDP port %u (max %u subscribers)",
+             static_cast<unsigned>(stream_port_), static_cast<unsigned>(stream_max_subscribers_));
+  }
+
+  // "SUB <token>" / "BYE <token>"; anything else (including a wrong token) is rejected.
+  // Returns true for a valid datagram and sets bye accordingly.
+  bool stream_parse_request_(const char *buf, int len, bool &bye) const {
+    if (stream_token_.empty() || len != static_cast<int>(4 + stream_token_.size())) return false;
+    if (std::memcmp(buf, "SUB ", 4) == 0) bye = false;
+    else if (std::memcmp(buf, "BYE ", 4) == 0) bye = true;
+    else return false;
+    return std::memcmp(buf + 4, stream_token_.data(), stream_token_.size()) == 0;
+  }
+
+  // Handle subscribe / keepalive / unsubscribe datagrams. Bounded per loop so a flood cannot stall us.
+  void stream_poll_subscribers_(uint32_t now) {
+    for (uint8_t n = 0; n < 4; ++n) {
+      char buf[4 + STREAM_MAX_TOKEN + 1];  // one spare byte so an over-long datagram is not a match
+      struct sockaddr_in from{};
+      socklen_t from_len = sizeof(from);
+      int len = recvfrom(stream_sock_, buf, sizeof(buf), MSG_DONTWAIT, reinterpret_cast<struct sockaddr *>(&from), &from_len);
+      if (len < 0) break;
+
+      bool bye = false;
+      if (!stream_parse_request_(buf, len, bye)) {
+        stream_bad_token_++;
+        continue;
+      }
+
+      int slot = -1, free_slot = -1;
+      for (uint8_t i = 0; i < stream_max_subscribers_; ++i) {
+        if (stream_subs_[i].active && stream_subs_[i].addr.sin_addr.s_addr == from.sin_addr.s_addr &&
+            stream_subs_[i].addr.sin_port == from.sin_port) { slot = i; break; }
+        if (!stream_subs_[i].active && free_slot < 0) free_slot = i;
+      }
+
+      if (bye) {
+        if (slot >= 0) {
+          stream_subs_[slot].active = false;
+          ESP_LOGI(TAG, "Stream: subscriber %u unsubscribed", static_cast<unsigned>(slot));
+        }
+        continue;
+      }
+      if (slot >= 0) {
+        stream_subs_[slot].last_seen_ms = now;
+        continue;
+      }
+      if (free_slot < 0) {
+        stream_rejected_subscribers_++;
+        ESP_LOGW(TAG, "Stream: subscriber limit (%u) reached, ignoring new subscriber", static_cast<unsigned>(stream_max_subscribers_));
+        continue;
+      }
+      StreamSubscriber &sub = stream_subs_[free_slot];
+      sub = StreamSubscriber{};
+      sub.active = true;
+      sub.addr = from;
+      sub.last_seen_ms = now;
+      ESP_LOGI(TAG, "Stream: subscriber %u added", static_cast<unsigned>(free_slot));
+    }
+
+    for (uint8_t i = 0; i < STREAM_MAX_SUBSCRIBERS; ++i) {
+      if (stream_subs_[i].active && (now - stream_subs_[i].last_seen_ms) >= STREAM_SUBSCRIBER_TIMEOUT_MS) {
+        stream_subs_[i].active = false;
+        ESP_LOGI(TAG, "Stream: subscriber %u timed out", static_cast<unsigned>(i));
+      }
+    }
+  }
+
+  // Packet layout (little-endian):
+  //   0  char[4] "SPAF"          4  u8 version        5  u8 frame count     6  u16 sequence
+  //   8  u32 frames captured    12  u32 partial frames  16  u32 ring overruns  20  u32 send drops
+  //   24 u32 rejected clock glitches
+  //   28 frame entries: u32 capture timestamp (esp_timer us, low 32 bits), u32 (bits << 24) | raw
+  void build_stream_header_() {
+    uint8_t *h = stream_batch_;
+    std::memcpy(h, "SPAF", 4);
+    h[4] = STREAM_VERSION;
+    h[5] = stream_batch_count_;
+    std::memcpy(h + 6, &stream_seq_, 2);
+    uint32_t captured, overruns, glitches;
+    portENTER_CRITICAL(&spinlock_);
+    captured = captured_frame_count_;
+    overruns = ring_overruns_;
+    glitches = glitch_count_;
+    portEXIT_CRITICAL(&spinlock_);
+    std::memcpy(h + 8, &captured, 4);
+    std::memcpy(h + 12, &total_partial_frames_, 4);
+    std::memcpy(h + 16, &overruns, 4);
+    std::memcpy(h + 20, &stream_send_drops_, 4);
+    std::memcpy(h + 24, &glitches, 4);
+  }
+
+  void stream_flush_() {
+    build_stream_header_();
+    size_t len = STREAM_HEADER_SIZE + stream_batch_count_ * STREAM_ENTRY_SIZE;
+    for (uint8_t i = 0; i < STREAM_MAX_SUBSCRIBERS; ++i) {
+      StreamSubscriber &sub = stream_subs_[i];
+      if (!sub.active) continue;
+      int sent = sendto(stream_sock_, stream_batch_, len, MSG_DONTWAIT,
+                        reinterpret_cast<struct sockaddr *>(&sub.addr), sizeof(sub.addr));
+      if (sent == static_cast<int>(len)) {
+        sub.consecutive_failures = 0;
+        continue;
+      }
+      // Back-pressure: never retry or wait, just account for the miss
+      sub.dropped_packets++;
+      stream_send_drops_++;
+      if (++sub.consecutive_failures >= STREAM_MAX_SEND_FAILURES) {
+        sub.active = false;
+        ESP_LOGW(TAG, "Stream: subscriber %u evicted after %u failed sends (errno=%d)",
+                 static_cast<unsigned>(i), static_cast<unsigned>(sub.consecutive_failures), errno);
+      }
+    }
+    stream_seq_++;
+    stream_packets_sent_++;
+    stream_batch_count_ = 0;
+  }
+
+  void stream_service_(uint32_t now) {
+    if (stream_sock_ < 0) {
+      stream_open_(now);
+      if (stream_sock_ < 0) return;
+    }
+    stream_poll_subscribers_(now);
+
+    bool any_subscriber = false;
+    for (uint8_t i = 0; i < STREAM_MAX_SUBSCRIBERS; ++i) any_subscriber |= stream_subs_[i].active;
+
+    // Drain the capture ring; convert cycle counts to esp_timer microseconds relative to now
+    int64_t now_us = esp_timer_get_time();
+    uint32_t now_cc = get_cycle_count();
+    while (true) {
+      uint32_t raw, cc;
+      uint8_t bits;
+      portENTER_CRITICAL(&spinlock_);
+      bool empty = (ring_tail_ == ring_head_);
+      if (!empty) {
+        raw = ring_raw_[ring_tail_];
+        bits = ring_bits_[ring_tail_];
+        cc = ring_ccount_[ring_tail_];
+        ring_tail_ = static_cast<uint8_t>((ring_tail_ + 1) % CAPTURE_RING_SIZE);
+      }
+      portEXIT_CRITICAL(&spinlock_);
+      if (empty) break;
+      if (!any_subscriber) continue;  // keep the ring drained even when nobody listens
+
+      uint32_t ts = static_cast<uint32_t>(now_us - static_cast<int64_t>((now_cc - cc) / CYCLES_PER_US));
+      uint32_t word = (static_cast<uint32_t>(bits) << 24) | (raw & 0xFFFFFF);
+      uint8_t *e = stream_batch_ + STREAM_HEADER_SIZE + stream_batch_count_ * STREAM_ENTRY_SIZE;
+      std::memcpy(e, &ts, 4);
+      std::memcpy(e + 4, &word, 4);
+      if (stream_batch_count_++ == 0) stream_batch_started_ms_ = now;
+      if (stream_batch_count_ >= STREAM_BATCH_FRAMES) stream_flush_();
+    }
+
+    if (!any_subscriber) {
+      stream_batch_count_ = 0;
+      return;
+    }
+    if (stream_batch_count_ > 0 && (now - stream_batch_started_ms_) >= STREAM_FLUSH_MS) stream_flush_();
+
+    if (now - stream_last_stats_ms_ >= STREAM_STATS_LOG_MS) {
+      stream_last_stats_ms_ = now;
+      ESP_LOGI(TAG, "Stream stats: packets=%u send_drops=%u ring_overruns=%u rejected_subscribers=%u bad_token=%u",
+               static_cast<unsigned>(stream_packets_sent_), static_cast<unsigned>(stream_send_drops_),
+               static_cast<unsigned>(ring_overruns_), static_cast<unsigned>(stream_rejected_subscribers_),
+               static_cast<unsigned>(stream_bad_token_));
+    }
+  }
+
   void IRAM_ATTR on_clock_edge_isr() {
     // ISR: detect frame gap by measuring cycles since last clock edge using CPU ccount
     // If gap > FRAME_GAP_CYCLES we treat as new frame and reset bit counter.
@@ -782,15 +1738,31 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
     portENTER_CRITICAL_ISR(&spinlock_);
 
     uint32_t now_ccount = get_cycle_count();
+    // Glitch rejection: too soon after the previous accepted edge. last_clock_ccount is left
+    // untouched so spacing keeps being measured from the real edge.
+    if (glitch_filter_cycles_ != 0 && last_clock_ccount != 0 &&
+        (now_ccount - last_clock_ccount) < glitch_filter_cycles_) {
+      glitch_count_++;
+      portEXIT_CRITICAL_ISR(&spinlock_);
+      return;
+    }
     if (last_clock_ccount != 0 && (now_ccount - last_clock_ccount) > FRAME_GAP_CYCLES) {
+      // More bits than a frame between two gaps: keep the history for the loop to realign
+      // (longer spans than the history holds are noise bursts and are not recoverable). The
+      // leftover bits of such a span are handled by the resync, not counted as a partial frame.
+      bool resync = bits_since_gap_ > Protocol::FRAME_BITS && bits_since_gap_ <= 64;
       // Detected frame gap — save frame if it has enough bits, otherwise count as partial
-      if (bit_count >= 21) {
-        completed_frame = shift_reg;
-        completed_bits  = bit_count;
-        frame_ready     = true;
-      } else if (bit_count > 0) {
+      if (bit_count >= Protocol::MIN_FRAME_BITS) {
+        complete_frame_isr_(shift_reg, bit_count, last_clock_ccount);  // stamped at its last bit
+      } else if (bit_count > 0 && !resync) {
         partial_frame_count++;
       }
+      if (resync) {
+        resync_history_ = bit_history_;
+        resync_bits_    = bits_since_gap_;
+        resync_ready_   = true;
+      }
+      bits_since_gap_ = 0;
       // Start a new frame
       shift_reg = 0;
       bit_count = 0;
@@ -812,11 +1784,11 @@ class HotTubDisplaySensor : public esphome::Component, public esphome::sensor::S
 
     shift_reg = (shift_reg << 1) | static_cast<uint32_t>(bit);
     bit_count++;
+    bit_history_ = (bit_history_ << 1) | static_cast<uint64_t>(bit);
+    if (bits_since_gap_ < 255) bits_since_gap_++;
 
-    if (bit_count == 24) {
-      completed_frame = shift_reg;
-      completed_bits  = 24;
-      frame_ready     = true;
+    if (bit_count == Protocol::FRAME_BITS) {
+      complete_frame_isr_(shift_reg, Protocol::FRAME_BITS, start_ccount);
       shift_reg       = 0;
       bit_count       = 0;
     }
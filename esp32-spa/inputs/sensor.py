@@ -1,7 +1,8 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import sensor as sensor_ns
-from esphome.const import CONF_ID
+from esphome.const import CONF_ID, ENTITY_CATEGORY_DIAGNOSTIC
+from esphome.core import TimePeriod
 from esphome.cpp_types import Component
 
 # Expose the C++ class `HotTubDisplaySensor` (defined in esp32-spa.h)
@@ -10,12 +11,40 @@ HotTubDisplaySensor = esp32_spa_ns.class_('HotTubDisplaySensor', Component)
 
 CONF_MEASURED_TEMP = 'measured_temp'
 CONF_SET_TEMP = 'set_temp'
+CONF_PRESS_LATENCY = 'press_latency'
+CONF_STREAM_PORT = 'stream_port'
+CONF_STREAM_MAX_SUBSCRIBERS = 'stream_max_subscribers'
+CONF_STREAM_TOKEN = 'stream_token'
+CONF_STALL_TIMEOUT = 'stall_timeout'
+CONF_GLITCH_FILTER = 'glitch_filter'
+CONF_HEARTBEAT_INTERVAL = 'heartbeat_interval'
 
-# Two temperature sensors
+# Two temperature sensors, plus an optional UDP raw-frame stream
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(HotTubDisplaySensor),
     cv.Optional(CONF_MEASURED_TEMP): sensor_ns.sensor_schema(),
     cv.Optional(CONF_SET_TEMP): sensor_ns.sensor_schema(),
+    cv.Optional(CONF_PRESS_LATENCY): sensor_ns.sensor_schema(
+        unit_of_measurement='ms',
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # At least several ~20ms frame periods, or the watchdog would trip between two good frames
+    cv.Optional(CONF_STALL_TIMEOUT, default='1000ms'): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(min=TimePeriod(milliseconds=100)),
+    ),
+    # 0s disables the heartbeat; API clients still get a full snapshot when they connect
+    cv.Optional(CONF_HEARTBEAT_INTERVAL, default='30s'): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_GLITCH_FILTER, default='0us'): cv.All(
+        cv.positive_time_period_microseconds,
+        # Half the 37us clock period: longer filters reject real edges once ISR latency jitter eats the margin
+        cv.Range(max=TimePeriod(microseconds=18)),
+    ),
+    # Plain UDP: every subscribe/keepalive/unsubscribe datagram must carry this shared token
+    cv.Inclusive(CONF_STREAM_PORT, 'stream'): cv.port,
+    cv.Inclusive(CONF_STREAM_TOKEN, 'stream'): cv.All(cv.string_strict, cv.Length(min=8, max=32)),
+    cv.Optional(CONF_STREAM_MAX_SUBSCRIBERS, default=2): cv.int_range(min=1, max=8),
 }).extend(cv.COMPONENT_SCHEMA)
 
 
@@ -23,6 +52,9 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
     cg.add(var)
+    cg.add(var.set_stall_timeout(config[CONF_STALL_TIMEOUT].total_milliseconds))
+    cg.add(var.set_glitch_filter_us(config[CONF_GLITCH_FILTER].total_microseconds))
+    cg.add(var.set_heartbeat_interval(config[CONF_HEARTBEAT_INTERVAL].total_milliseconds))
 
     if CONF_MEASURED_TEMP in config:
         sens = await sensor_ns.new_sensor(config[CONF_MEASURED_TEMP])
@@ -31,3 +63,12 @@ async def to_code(config):
     if CONF_SET_TEMP in config:
         sens = await sensor_ns.new_sensor(config[CONF_SET_TEMP])
         cg.add(var.set_set_temp_sensor(sens))
+
+    if CONF_PRESS_LATENCY in config:
+        sens = await sensor_ns.new_sensor(config[CONF_PRESS_LATENCY])
+        cg.add(var.set_press_latency_sensor(sens))
+
+    if CONF_STREAM_PORT in config:
+        cg.add(var.set_stream_port(config[CONF_STREAM_PORT]))
+        cg.add(var.set_stream_token(config[CONF_STREAM_TOKEN]))
+        cg.add(var.set_stream_max_subscribers(config[CONF_STREAM_MAX_SUBSCRIBERS]))
@@ -11,7 +11,7 @@ CONF_PARENT_ID = 'parent_id'
 # This platform requires referencing an existing HotTubDisplaySensor instance
 CONFIG_SCHEMA = text_sensor.text_sensor_schema().extend({
     cv.Required(CONF_PARENT_ID): cv.use_id(HotTubDisplaySensor),
-    cv.Required('type'): cv.enum({'error_code': 'ERROR_CODE', 'spa_mode': 'SPA_MODE'}),
+    cv.Required('type'): cv.enum({'error_code': 'ERROR_CODE', 'spa_mode': 'SPA_MODE', 'bus_state': 'BUS_STATE'}),
 })
 
 
@@ -23,4 +23,6 @@ async def to_code(config):
     if sensor_type == 'error_code':
         cg.add(parent.set_error_text_sensor(var))
     elif sensor_type == 'spa_mode':
-        cg.add(parent.set_spa_mode_text_sensor(var))
\ No newline at end of file
+        cg.add(parent.set_spa_mode_text_sensor(var))
+    elif sensor_type == 'bus_state':
+        cg.add(parent.set_bus_state_text_sensor(var))
\ No newline at end of file
@@ -0,0 +1,166 @@
+#pragma once
+
+// Drives HotTubDisplaySensor through its clock ISR with GS100 bus timing, interleaved with the
+// ESPHome main loop. Timing follows the logic-analyzer observations in the README: a ~37 us clock
+// period (~16 us high, ~21 us low), 24 bits per frame, ~19 ms low between frames. The data line
+// changes half a clock period before each rising edge, so the ISR samples it mid-bit.
+
+#include "host.h"
+#include "esp32-spa.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace gs100 {
+
+// Segment patterns come from the decoder's own tables, so the two cannot drift apart
+constexpr const uint8_t *DIGITS = esp32_spa::SEVEN_SEG_DIGITS;
+constexpr uint8_t BLANK = 0x00;
+
+inline uint8_t glyph(char c) {
+  if (c >= '0' && c <= '9') return DIGITS[c - '0'];
+  for (const auto &l : esp32_spa::SEVEN_SEG_LETTERS) {
+    if (l.ch == c) return l.pattern;
+  }
+  return BLANK;
+}
+
+struct Status {
+  bool heater = false;
+  bool pump = false;
+  bool light = false;
+};
+
+// p1 = hundreds flag + heater bit, p2/p3 = glyphs, p4 = pump/light
+inline uint32_t encode(bool hundreds, uint8_t p2, uint8_t p3, const Status &st) {
+  uint32_t p1 = (hundreds ? 0x30u : 0u) | (st.heater ? 0x04u : 0u);
+  uint32_t p4 = (st.pump ? 0x4u : 0u) | (st.light ? 0x2u : 0u);
+  return (p1 << 17) | (static_cast<uint32_t>(p2) << 10) | (static_cast<uint32_t>(p3) << 3) | p4;
+}
+inline uint32_t temp_frame(int temp, const Status &st) {
+  return encode(temp >= 100, DIGITS[(temp / 10) % 10], DIGITS[temp % 10], st);
+}
+inline uint32_t text_frame(char c2, char c3, const Status &st) { return encode(false, glyph(c2), glyph(c3), st); }
+inline uint32_t blank_frame(const Status &st) { return encode(false, BLANK, BLANK, st); }
+
+// Spurious clock edges (e.g. pump-motor spikes on a long cable)
+struct Noise {
+  double glitch_per_frame = 0.0;   // probability that a frame carries one extra clock edge
+  uint32_t min_offset_ns = 0;      // spike position after the preceding real edge
+  uint32_t max_offset_ns = 37000;
+  uint32_t isr_latency_max_ns = 0; // each edge reaches the ISR 0..this late (other interrupts, cache misses)
+};
+
+class BusSim {
+ public:
+  static constexpr uint32_t BIT_PERIOD_NS = 37000;
+  static constexpr uint32_t FRAME_BITS = 24;
+  static constexpr uint32_t FRAME_GAP_US = 19000;
+  static constexpr uint32_t FRAME_PERIOD_US = FRAME_BITS * BIT_PERIOD_NS / 1000 + FRAME_GAP_US;
+  static constexpr uint32_t LOOP_INTERVAL_US = 16000;  // ESPHome default loop interval
+
+  // frame_source returns the 24-bit frame the controller sends at the given time (ms)
+  BusSim(esp32_spa::HotTubDisplaySensor &spa, std::function<uint32_t(uint32_t now_ms)> frame_source, uint32_t seed = 1)
+      : spa_(spa), frame_source_(std::move(frame_source)), rng_(seed) {
+    host::gpio_read = [this](int pin) { return pin == ::DATA_PIN ? data_level_(host::now_us() * 1000) : 0; };
+  }
+
+  Noise noise;
+  bool realtime = false;               // pace virtual time with the wall clock (for live clients)
+  std::function<void()> after_loop;    // called after every loop() iteration
+
+  uint32_t frames_sent = 0;
+  uint32_t glitches_injected = 0;
+  uint64_t loop_calls = 0;
+  uint64_t loop_max_ns = 0;            // wall-clock duration of the slowest loop() call
+  uint64_t loop_total_ns = 0;
+
+  void run_for_ms(uint32_t ms) {
+    uint64_t end_us = host::now_us() + static_cast<uint64_t>(ms) * 1000;
+    if (next_frame_us_ == 0) next_frame_us_ = host::now_us() + 1000;
+    if (next_loop_us_ == 0) next_loop_us_ = host::now_us();
+    auto wall0 = std::chrono::steady_clock::now();
+    uint64_t sim0 = host::now_us();
+
+    while (true) {
+      uint64_t edge_us = edges_.empty() ? UINT64_MAX : edges_.front() / 1000;
+      uint64_t t = std::min({edge_us, next_loop_us_, next_frame_us_});
+      if (t >= end_us) break;
+      if (realtime) std::this_thread::sleep_until(wall0 + std::chrono::microseconds(t - sim0));
+
+      if (t == next_frame_us_) {
+        start_frame_(next_frame_us_ * 1000);
+        next_frame_us_ += FRAME_PERIOD_US;
+      } else if (t == edge_us) {
+        uint64_t edge_ns = edges_.front();
+        edges_.pop_front();
+        host::set_time_us(edge_ns / 1000);
+        esp32_spa_isr_wrapper(&spa_);
+      } else {
+        host::set_time_us(next_loop_us_);
+        host::run_timers();
+        auto w = std::chrono::steady_clock::now();
+        spa_.loop();
+        uint64_t d = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - w).count();
+        loop_calls++;
+        loop_total_ns += d;
+        if (d > loop_max_ns) loop_max_ns = d;
+        if (after_loop) after_loop();
+        next_loop_us_ += LOOP_INTERVAL_US;
+      }
+    }
+    host::set_time_us(end_us);
+  }
+
+ private:
+  // Data line: bit i is driven from half a period before edge i until half a period after it
+  int data_level_(uint64_t t_ns) const {
+    if (t_ns + BIT_PERIOD_NS / 2 < frame_t0_ns_) return 0;
+    uint64_t i = (t_ns + BIT_PERIOD_NS / 2 - frame_t0_ns_) / BIT_PERIOD_NS;
+    if (i >= FRAME_BITS) return 0;
+    return (frame_bits_ >> (FRAME_BITS - 1 - i)) & 1;
+  }
+
+  void start_frame_(uint64_t t0_ns) {
+    frame_t0_ns_ = t0_ns;
+    frame_bits_ = frame_source_(static_cast<uint32_t>(t0_ns / 1000000));
+    frames_sent++;
+    int glitch_after = -1;
+    if (noise.glitch_per_frame > 0 && std::uniform_real_distribution<double>(0, 1)(rng_) < noise.glitch_per_frame) {
+      glitch_after = std::uniform_int_distribution<int>(0, FRAME_BITS - 1)(rng_);
+    }
+    size_t first = edges_.size();
+    for (uint32_t i = 0; i < FRAME_BITS; ++i) {
+      uint64_t edge = t0_ns + static_cast<uint64_t>(i) * BIT_PERIOD_NS;
+      edges_.push_back(edge + latency_());
+      if (static_cast<int>(i) == glitch_after) {
+        uint32_t off = std::uniform_int_distribution<uint32_t>(noise.min_offset_ns, noise.max_offset_ns)(rng_);
+        edges_.push_back(edge + off + latency_());
+        glitches_injected++;
+      }
+    }
+    // Latency can reorder a spike and its neighbouring edge; the ISR still runs in time order
+    std::sort(edges_.begin() + first, edges_.end());
+  }
+
+  uint32_t latency_() {
+    if (noise.isr_latency_max_ns == 0) return 0;
+    return std::uniform_int_distribution<uint32_t>(0, noise.isr_latency_max_ns)(rng_);
+  }
+
+  esp32_spa::HotTubDisplaySensor &spa_;
+  std::function<uint32_t(uint32_t)> frame_source_;
+  std::mt19937 rng_;
+  std::deque<uint64_t> edges_;  // pending rising edges, ns
+  uint64_t next_frame_us_ = 0;
+  uint64_t next_loop_us_ = 0;
+  uint64_t frame_t0_ns_ = 0;
+  uint32_t frame_bits_ = 0;
+};
+
+}  // namespace gs100
@@ -0,0 +1,120 @@
+#pragma once
+
+// Display-side model of a GS100 controller with a VL260 topside: what it shows in response to
+// the Warm / Cool / Light buttons. Feed frame() to gs100::BusSim as the frame source and hook
+// press() to the button outputs.
+//
+// Behaviour (per the README and the decoder's own comments):
+//   - Warm/Cool enters the set-temp flash sequence: set temp alternating with blanks. The first
+//     press only shows the set temp; further presses in the sequence change it by one degree.
+//   - Light during the sequence shows the mode string (St/Ec/SL) in place of the blanks; each
+//     further Light press cycles the mode. Light outside the sequence toggles the light.
+//   - The sequence ends SET_SEQUENCE_MS after the last press and the measured temp returns.
+//   - An active error code replaces the measured temperature.
+// The flash cadence and reaction delay are not in the README's logic-analyzer capture; they are
+// parameters (Timing) so a capture from a real tub can be plugged in.
+
+#include "gs100_bus.h"
+
+#include <cstdint>
+#include <string>
+
+namespace gs100 {
+
+enum class Button : uint8_t { WARM, COOL, LIGHT, PUMP };
+enum class Mode : uint8_t { STANDARD, ECONOMY, SLEEP };
+
+inline const char *mode_name(Mode m) {
+  return m == Mode::STANDARD ? "Standard" : m == Mode::ECONOMY ? "Economy" : "Sleep";
+}
+
+class Emulator {
+ public:
+  struct Timing {
+    uint32_t reaction_ms = 50;          // press -> display change
+    uint32_t flash_on_ms = 450;         // set temp (digits) visible
+    uint32_t flash_off_ms = 450;        // blank or mode string
+    uint32_t set_sequence_ms = 5000;    // sequence ends this long after the last press
+  };
+  Timing timing;
+
+  int measured = 100;
+  int set_temp = 102;
+  int min_set = 80, max_set = 104;
+  Mode mode = Mode::STANDARD;
+  std::string error;                    // e.g. "OH"; empty = none
+  Status status;
+
+  // A button press reaches the controller now; it acts on it after timing.reaction_ms
+  void press(Button b, uint32_t now_ms) {
+    pending_ = b;
+    pending_at_ms_ = now_ms + timing.reaction_ms;
+    has_pending_ = true;
+  }
+
+  bool in_sequence(uint32_t now_ms) {
+    apply_pending_(now_ms);
+    return in_seq_ && now_ms - last_press_ms_ < timing.set_sequence_ms;
+  }
+
+  // The frame the controller sends at now_ms
+  uint32_t frame(uint32_t now_ms) {
+    apply_pending_(now_ms);
+    if (in_seq_ && now_ms - last_press_ms_ >= timing.set_sequence_ms) in_seq_ = false;
+    if (!in_seq_) {
+      if (!error.empty()) return text_frame(error[0], error.size() > 1 ? error[1] : ' ', status);
+      return temp_frame(measured, status);
+    }
+    uint32_t phase = (now_ms - seq_started_ms_) % (timing.flash_on_ms + timing.flash_off_ms);
+    if (phase < timing.flash_on_ms) return temp_frame(set_temp, status);
+    if (!mode_select_) return blank_frame(status);
+    static const char *const CODES[] = {"St", "Ec", "SL"};
+    const char *c = CODES[static_cast<int>(mode)];
+    return text_frame(c[0], c[1], status);
+  }
+
+ private:
+  void apply_pending_(uint32_t now_ms) {
+    if (!has_pending_ || now_ms < pending_at_ms_) return;
+    has_pending_ = false;
+    uint32_t t = pending_at_ms_;
+    bool active = in_seq_ && t - last_press_ms_ < timing.set_sequence_ms;
+    switch (pending_) {
+      case Button::WARM:
+      case Button::COOL:
+        if (!active) {
+          in_seq_ = true;
+          mode_select_ = false;
+          seq_started_ms_ = t;
+        } else if (pending_ == Button::WARM) {
+          if (set_temp < max_set) set_temp++;
+        } else if (set_temp > min_set) {
+          set_temp--;
+        }
+        last_press_ms_ = t;
+        break;
+      case Button::LIGHT:
+        if (!active) {
+          status.light = !status.light;
+          break;
+        }
+        if (mode_select_) mode = static_cast<Mode>((static_cast<int>(mode) + 1) % 3);
+        mode_select_ = true;
+        last_press_ms_ = t;
+        break;
+      case Button::PUMP:
+        status.pump = !status.pump;
+        break;
+    }
+  }
+
+  Button pending_ = Button::WARM;
+  bool has_pending_ = false;
+  uint32_t pending_at_ms_ = 0;
+  bool in_seq_ = false;
+  bool mode_select_ = false;
+  uint32_t seq_started_ms_ = 0;
+  uint32_t last_press_ms_ = 0;
+};
+
+}  // namespace gs100
@@ -0,0 +1,96 @@
+#include "host.h"
+
+#include "esphome.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <list>
+#include <string>
+
+namespace host {
+
+static uint64_t g_cycles = 0;
+
+uint64_t now_cycles() { return g_cycles; }
+uint64_t now_us() { return g_cycles / CPU_MHZ; }
+void set_time_us(uint64_t us) {
+  uint64_t c = us * CPU_MHZ;
+  if (c > g_cycles) g_cycles = c;  // time never runs backwards
+}
+
+std::function<int(int)> gpio_read;
+std::function<void(int, int)> gpio_write;
+bool network_up = false;
+int log_level = 1;
+
+struct Timer {
+  const esphome::Component *owner;
+  std::string name;
+  uint64_t due_us;
+  std::function<void()> fn;
+};
+static std::list<Timer> g_timers;
+
+void run_timers() {
+  bool fired = true;
+  while (fired) {  // a callback may schedule another one that is already due
+    fired = false;
+    for (auto it = g_timers.begin(); it != g_timers.end(); ++it) {
+      if (it->due_us > now_us()) continue;
+      auto fn = std::move(it->fn);
+      g_timers.erase(it);
+      fn();
+      fired = true;
+      break;
+    }
+  }
+}
+
+void log(char level, const char *tag, const char *fmt, ...) {
+  int need = level == 'W' || level == 'E' ? 1 : level == 'I' ? 2 : 3;
+  if (log_level < need) return;
+  std::printf("[%9.3f][%c][%s] ", static_cast<double>(now_us()) / 1e6, level, tag);
+  va_list ap;
+  va_start(ap, fmt);
+  std::vprintf(fmt, ap);
+  va_end(ap);
+  std::printf("\n");
+}
+
+}  // namespace host
+
+namespace esphome {
+
+uint32_t millis() { return static_cast<uint32_t>(host::now_us() / 1000); }
+
+void Component::set_timeout(const std::string &name, uint32_t ms, std::function<void()> &&fn) {
+  // Same semantics as ESPHome: a timeout with the same name replaces the pending one
+  host::g_timers.remove_if([&](const host::Timer &t) { return t.owner == this && t.name == name; });
+  host::g_timers.push_back({this, name, host::now_us() + static_cast<uint64_t>(ms) * 1000, std::move(fn)});
+}
+
+namespace network {
+bool is_connected() { return host::network_up; }
+}  // namespace network
+
+}  // namespace esphome
+
+int64_t esp_timer_get_time() { return static_cast<int64_t>(host::now_us()); }
+
+extern "C" uint32_t esp32_spa_host_cycle_count() {
+  host::g_cycles += 12;  // ~50 ns per read
+  return static_cast<uint32_t>(host::g_cycles);
+}
+
+int gpio_config(const gpio_config_t *) { return 0; }
+int gpio_install_isr_service(int) { return 0; }
+int gpio_isr_handler_add(gpio_num_t, void (*)(void *), void *) { return 0; }
+int gpio_set_intr_type(gpio_num_t, gpio_int_type_t) { return 0; }
+int gpio_set_direction(gpio_num_t, gpio_mode_t) { return 0; }
+int gpio_set_level(gpio_num_t pin, uint32_t level) {
+  if (host::gpio_write) host::gpio_write(pin, static_cast<int>(level));
+  return 0;
+}
+int gpio_get_level(gpio_num_t pin) { return host::gpio_read ? host::gpio_read(pin) : 0; }
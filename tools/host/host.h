@@ -0,0 +1,33 @@
+#pragma once
+
+// Host runtime for building esp32-spa.h off-target: a virtual clock shared by millis(),
+// esp_timer_get_time() and the ISR cycle counter, the Component timer queue, GPIO hooks
+// and log output. The stand-in ESP-IDF / ESPHome headers in stubs/ forward to this.
+
+#include <cstdint>
+#include <functional>
+
+namespace host {
+
+constexpr uint32_t CPU_MHZ = 240;  // matches HotTubDisplaySensor::CPU_MHZ
+
+// Virtual time in CPU cycles. Each cycle-counter read advances it slightly so the ISR's
+// busy-wait terminates; everything else only moves when a runner calls set_time_us().
+uint64_t now_cycles();
+uint64_t now_us();
+void set_time_us(uint64_t us);
+
+// Fire Component::set_timeout() callbacks that are due (ESPHome runs them from the main loop)
+void run_timers();
+
+// GPIO: level of an input pin at the current virtual time, and writes to output pins
+extern std::function<int(int pin)> gpio_read;
+extern std::function<void(int pin, int level)> gpio_write;
+
+extern bool network_up;  // esphome::network::is_connected()
+
+// 0 = silent, 1 = warnings, 2 = info, 3 = debug
+extern int log_level;
+void log(char level, const char *tag, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+}  // namespace host
@@ -0,0 +1,217 @@
+// Press-to-publish latency benchmark against the GS100 display emulator. Each scenario injects a
+// button press the way the YAML buttons do (note_*_press(), then the output pin), with a random
+// phase against the frame and flash timing, and waits for the matching publish. At that moment
+// the published value must equal what the emulated controller is showing; an early confirmation
+// from stale display data counts as "wrong". Deterministic for a given seed.
+//
+//   latency_bench [trials per scenario] [seed]
+
+#include "gs100_emulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Result {
+  explicit Result(const char *n) : name(n) {}
+  const char *name;
+  std::vector<uint32_t> ms;
+  uint32_t missed = 0;
+  uint32_t wrong = 0;
+};
+
+class Bench {
+ public:
+  explicit Bench(uint32_t seed)
+      : rng_(seed), bus_(spa_, [this](uint32_t now_ms) { return emu_.frame(now_ms); }, seed) {
+    spa_.set_measured_temp_sensor(&measured_);
+    spa_.set_set_temp_sensor(&set_);
+    spa_.set_press_latency_sensor(&latency_);
+    spa_.set_error_text_sensor(&error_);
+    spa_.set_spa_mode_text_sensor(&mode_);
+    spa_.set_light_sensor(&light_);
+    set_.add_on_state_callback([this](float v) { set_pub_ = {esphome::millis(), v}; });
+    // The set-temp flash must never be published as the measured temperature
+    measured_.add_on_state_callback([this](float v) {
+      if (static_cast<int>(v) != emu_.measured) wrong_measured++;
+    });
+    latency_.add_on_state_callback([this](float v) { latency_pub_ = {esphome::millis(), v}; });
+    error_.add_on_state_callback([this](std::string v) { error_pub_ = {esphome::millis(), v}; });
+    mode_.add_on_state_callback([this](std::string v) { mode_pub_ = {esphome::millis(), v}; });
+    light_.add_on_state_callback([this](bool v) { light_pub_ = {esphome::millis(), v}; });
+
+    // The component's own refresh presses reach the emulator through the button pins
+    host::gpio_write = [this](int pin, int level) {
+      if (level == 0) return;
+      if (pin == PIN_WRITE_BTN1) emu_.press(gs100::Button::WARM, esphome::millis());
+      if (pin == PIN_WRITE_BTN2) emu_.press(gs100::Button::COOL, esphome::millis());
+      if (pin == PIN_WRITE_BTN3) emu_.press(gs100::Button::LIGHT, esphome::millis());
+      if (pin == PIN_WRITE_PUMP) emu_.press(gs100::Button::PUMP, esphome::millis());
+    };
+
+    spa_.setup();
+    bus_.run_for_ms(12000);  // boot, including the automatic Cool + Light presses
+  }
+
+  uint32_t wrong_measured = 0;
+
+  // ---- scenarios ----
+
+  // Cool from the normal display: the set temp is shown, unchanged -> confirmed by a fresh capture
+  void show_set_temp(Result &r) {
+    idle_();
+    uint32_t t = press_(gs100::Button::COOL);
+    wait_(r, t, [&] { return latency_pub_.at >= t; }, [&] { return spa_.last_set_temp == emu_.set_temp; });
+  }
+
+  // Warm inside the sequence: the set temp goes up by one -> set temp publish of the new value
+  void raise_set_temp(Result &r) {
+    idle_();
+    if (emu_.set_temp >= emu_.max_set) emu_.set_temp = emu_.min_set + 10;
+    press_(gs100::Button::COOL);
+    run_(800 + rand_(0, 900));
+    float before = set_pub_.value;
+    uint32_t t = press_(gs100::Button::WARM);
+    wait_(r, t, [&] { return set_pub_.at >= t && set_pub_.value != before; },
+          [&] { return static_cast<int>(set_pub_.value) == emu_.set_temp && latency_pub_.at == set_pub_.at; });
+  }
+
+  // Light inside the sequence: the mode string replaces the blanks -> confirmed by the mode string
+  void show_mode(Result &r) {
+    idle_();
+    press_(gs100::Button::COOL);
+    run_(800 + rand_(0, 900));
+    uint32_t t = press_(gs100::Button::LIGHT);
+    wait_(r, t, [&] { return latency_pub_.at >= t; }, [&] { return spa_.last_mode_ == gs100::mode_name(emu_.mode); });
+  }
+
+  // A further Light press cycles the mode -> mode publish of the new mode
+  void cycle_mode(Result &r) {
+    idle_();
+    press_(gs100::Button::COOL);
+    run_(700 + rand_(0, 300));
+    press_(gs100::Button::LIGHT);
+    run_(1200 + rand_(0, 900));
+    std::string before = mode_pub_.value;
+    uint32_t t = press_(gs100::Button::LIGHT);
+    wait_(r, t, [&] { return mode_pub_.at >= t && mode_pub_.value != before; },
+          [&] { return mode_pub_.value == gs100::mode_name(emu_.mode) && latency_pub_.at == mode_pub_.at; });
+  }
+
+  // Light outside the sequence toggles the light -> light publish
+  void toggle_light(Result &r) {
+    idle_();
+    bool before = light_pub_.value;
+    uint32_t t = press_(gs100::Button::LIGHT);
+    wait_(r, t, [&] { return light_pub_.at >= t && light_pub_.value != before; },
+          [&] { return light_pub_.value == emu_.status.light && latency_pub_.at == light_pub_.at; });
+  }
+
+  // An error code appears on the display, later clears
+  void error_code(Result &shown, Result &cleared) {
+    idle_();
+    static const char *const CODES[] = {"OH", "HH", "dr", "SA", "Sn"};
+    std::string code = CODES[rand_(0, 4)];
+    emu_.error = code;
+    uint32_t t = esphome::millis();
+    wait_(shown, t, [&] { return error_pub_.at >= t && !error_pub_.value.empty(); },
+          [&] { return error_pub_.value.compare(0, 2, code) == 0; });
+    run_(rand_(1000, 3000));
+    emu_.error.clear();
+    t = esphome::millis();
+    wait_(cleared, t, [&] { return error_pub_.at >= t && error_pub_.value.empty(); }, [&] { return true; });
+  }
+
+ private:
+  template<typename T> struct Pub {
+    uint32_t at = 0;
+    T value{};
+  };
+
+  uint32_t rand_(uint32_t lo, uint32_t hi) { return std::uniform_int_distribution<uint32_t>(lo, hi)(rng_); }
+  void run_(uint32_t ms) { bus_.run_for_ms(ms); }
+
+  // Let any flash sequence end, then wait a random time so presses land at random phases
+  void idle_() {
+    while (emu_.in_sequence(esphome::millis()) || spa_.in_set_mode()) run_(100);
+    run_(2500 + rand_(0, 997));
+  }
+
+  // Same order as the YAML buttons: start the measurement, then drive the output
+  uint32_t press_(gs100::Button b) {
+    if (b == gs100::Button::LIGHT) spa_.note_light_press();
+    else spa_.note_temp_press();
+    emu_.press(b, esphome::millis());
+    return esphome::millis();
+  }
+
+  void wait_(Result &r, uint32_t t0, const std::function<bool()> &done, const std::function<bool()> &correct) {
+    while (!done()) {
+      if (esphome::millis() - t0 > esp32_spa::HotTubDisplaySensor::PRESS_CONFIRM_TIMEOUT_MS) {
+        r.missed++;
+        return;
+      }
+      run_(1);
+    }
+    r.ms.push_back(esphome::millis() - t0);
+    if (!correct()) r.wrong++;
+  }
+
+  std::mt19937 rng_;
+  esp32_spa::HotTubDisplaySensor spa_;
+  esphome::sensor::Sensor measured_, set_, latency_;
+  esphome::text_sensor::TextSensor error_, mode_;
+  esphome::binary_sensor::BinarySensor light_;
+  gs100::Emulator emu_;
+  gs100::BusSim bus_;
+  Pub<float> set_pub_, latency_pub_;
+  Pub<std::string> error_pub_, mode_pub_;
+  Pub<bool> light_pub_;
+};
+
+void report(const Result &r) {
+  std::vector<uint32_t> v = r.ms;
+  std::sort(v.begin(), v.end());
+  double avg = 0;
+  for (uint32_t x : v) avg += x;
+  if (!v.empty()) avg /= v.size();
+  auto pct = [&](double p) { return v.empty() ? 0u : v[std::min(v.size() - 1, static_cast<size_t>(std::ceil(p * v.size())) - 1)]; };
+  std::printf("  %-22s n=%-4zu min=%-5u avg=%-7.1f p95=%-5u max=%-5u missed=%u wrong=%u\n", r.name, v.size(),
+              v.empty() ? 0u : v.front(), avg, pct(0.95), v.empty() ? 0u : v.back(), r.missed, r.wrong);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int trials = argc > 1 ? std::atoi(argv[1]) : 50;
+  uint32_t seed = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 1;
+  host::log_level = 0;
+
+  Bench b(seed);
+  Result show{"cool: show set temp"}, raise{"warm: raise set temp"}, mode{"light: show mode"},
+      cycle{"light: cycle mode"}, light{"light: toggle light"}, err{"error code shown"}, clr{"error code cleared"};
+  for (int i = 0; i < trials; ++i) {
+    b.show_set_temp(show);
+    b.raise_set_temp(raise);
+    b.show_mode(mode);
+    b.cycle_mode(cycle);
+    b.toggle_light(light);
+    b.error_code(err, clr);
+  }
+
+  std::printf("latency_bench: %d trials per scenario, seed %u (ms from press/display change to publish)\n", trials, seed);
+  uint32_t bad = b.wrong_measured;
+  for (const Result *r : {&show, &raise, &mode, &cycle, &light, &err, &clr}) {
+    report(*r);
+    bad += r->missed + r->wrong;
+  }
+  std::printf("  measured temp publishes of a value other than the measured temp: %u\n", b.wrong_measured);
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+// Clock glitch filter benchmark: valid frames per second on a noisy bus for a range of
+// glitch_filter settings. Half of the frames carry one spurious clock edge; the spike profiles
+// place it right after a real edge (ringing), anywhere in the bit, or just before the next real
+// edge. Every edge also reaches the ISR up to a few us late; a second table sweeps that latency,
+// which is what a filter longer than half the clock period trips over (real edges arriving
+// closer than the filter get rejected). "wrong" counts publishes of values the bus never sent;
+// the exit status fails on any within the supported range (up to MAX_FILTER_US).
+// Deterministic for a given seed. A last table feeds resync_pick() every frame the bench can
+// show with each bit duplicated once (what an extra clock edge does) and counts how many spans it
+// recovers, with and without the last accepted frame as context.
+//
+//   noise_bench [seconds per run] [seed]
+
+#include "gs100_bus.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Profile {
+  const char *name;
+  uint32_t min_offset_ns, max_offset_ns;
+};
+
+struct Run {
+  uint32_t valid, recovered, failed, partials, rejected, glitches, sent, wrong;
+};
+
+// Components stay alive until exit: their boot timers are still queued on the shared host clock
+struct Rig {
+  esp32_spa::HotTubDisplaySensor spa;
+  esphome::sensor::Sensor measured;
+  esphome::text_sensor::TextSensor error, mode;
+  std::unique_ptr<gs100::BusSim> bus;
+  uint32_t wrong = 0;
+};
+std::vector<std::unique_ptr<Rig>> rigs;
+
+constexpr int MEASURED = 100;
+constexpr uint32_t MAX_FILTER_US = 18;  // sensor.py limit: half the 37us clock period
+
+Run run(const Profile &p, uint32_t filter_us, uint32_t isr_latency_ns, uint32_t seconds, uint32_t seed) {
+  rigs.push_back(std::make_unique<Rig>());
+  Rig &r = *rigs.back();
+  gs100::Status st;
+  st.light = true;
+  uint32_t frame = gs100::temp_frame(MEASURED, st);
+  r.spa.set_measured_temp_sensor(&r.measured);
+  r.spa.set_error_text_sensor(&r.error);
+  r.spa.set_spa_mode_text_sensor(&r.mode);
+  r.spa.set_glitch_filter_us(filter_us);
+  r.measured.add_on_state_callback([&r](float v) { if (static_cast<int>(v) != MEASURED) r.wrong++; });
+  r.error.add_on_state_callback([&r](std::string v) { if (!v.empty()) r.wrong++; });
+  r.mode.add_on_state_callback([&r](std::string v) { if (!v.empty()) r.wrong++; });
+  r.bus = std::make_unique<gs100::BusSim>(r.spa, [frame](uint32_t) { return frame; }, seed);
+  gs100::BusSim &bus = *r.bus;
+  r.spa.setup();
+
+  bus.noise.glitch_per_frame = 0.5;
+  bus.noise.min_offset_ns = p.min_offset_ns;
+  bus.noise.max_offset_ns = p.max_offset_ns;
+  bus.noise.isr_latency_max_ns = isr_latency_ns;
+
+  bus.run_for_ms(1000);  // settle: first frames, bus state "ok"
+  Run before{r.spa.valid_frames(), r.spa.resync_recovered(), r.spa.resync_failed(), r.spa.partial_frames(),
+             r.spa.glitches_rejected(), bus.glitches_injected, bus.frames_sent, r.wrong};
+  bus.run_for_ms(seconds * 1000);
+  return Run{r.spa.valid_frames() - before.valid,          r.spa.resync_recovered() - before.recovered,
+             r.spa.resync_failed() - before.failed,        r.spa.partial_frames() - before.partials,
+             r.spa.glitches_rejected() - before.rejected,  bus.glitches_injected - before.glitches,
+             bus.frames_sent - before.sent,                r.wrong - before.wrong};
+}
+
+struct Exhaustive {
+  uint32_t spans, passed, shifted, recovered, failed, wrong;
+};
+
+struct Context {
+  const char *name;
+  bool last, last_is_prev, next;
+};
+
+// Every distinct single-duplicated-bit span of temp frames 80-104 with any heater/pump/light
+// combination. "passed" spans deliver their first 24 bits as a valid frame and are never resynced
+// ("shifted": a different frame that still passes the checksums). A display change is modelled
+// as the previous temperature for last and this frame for next.
+Exhaustive exhaustive(const Context &c) {
+  using Spa = esp32_spa::HotTubDisplaySensor;
+  constexpr uint8_t N = gs100::BusSim::FRAME_BITS;
+  Exhaustive e{};
+  for (int temp = 80; temp <= 104; ++temp) {
+    for (int combo = 0; combo < 8; ++combo) {
+      gs100::Status st;
+      st.heater = combo & 1;
+      st.pump = combo & 2;
+      st.light = combo & 4;
+      uint32_t frame = gs100::temp_frame(temp, st);
+      uint32_t prev = gs100::temp_frame(temp - 1, st);
+      for (uint8_t p = 0; p < N; ++p) {
+        // Duplicating either bit of an equal pair gives the same span: count it once
+        if (p + 1 < N && ((frame >> p) & 1) == ((frame >> (p + 1)) & 1)) continue;
+        uint64_t span = (static_cast<uint64_t>(frame >> p) << (p + 1)) | (frame & ((1u << (p + 1)) - 1));
+        e.spans++;
+        uint32_t delivered = static_cast<uint32_t>(span >> 1);
+        if (Spa::full_frame_ok_(delivered)) {
+          e.passed++;
+          if (delivered != frame) e.shifted++;
+          continue;
+        }
+        const uint32_t *last = !c.last ? nullptr : c.last_is_prev ? &prev : &frame;
+        uint32_t out = 0;
+        if (Spa::resync_pick(span, N + 1, last, c.next ? &frame : nullptr, out) == Spa::ResyncPick::NONE) {
+          e.failed++;
+        } else if (out == frame) {
+          e.recovered++;
+        } else {
+          e.wrong++;
+        }
+      }
+    }
+  }
+  return e;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  uint32_t seconds = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 60;
+  uint32_t seed = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 1;
+  host::log_level = 0;
+
+  const uint32_t period_ns = gs100::BusSim::BIT_PERIOD_NS;
+  const Profile profiles[] = {
+      {"ringing (0.2-3us after edge)", 200, 3000},
+      {"anywhere in the bit", 200, period_ns - 200},
+      {"late (31-36.8us after edge)", 31000, period_ns - 200},
+  };
+  const uint32_t filters_us[] = {0, 2, 5, 10, 15, 18, 25, 30};
+  const uint32_t isr_latency_ns = 4000;
+  auto print_header = [] {
+    std::printf("    %-7s %8s %8s %8s %8s %8s %8s %6s\n", "filter", "sent/s", "valid/s", "rejected", "partial",
+                "resync+", "resync-", "wrong");
+  };
+  auto print_run = [seconds](uint32_t f, const Run &r) {
+    std::printf("    %4uus  %8.1f %8.1f %8u %8u %8u %8u %6u\n", f, static_cast<double>(r.sent) / seconds,
+                static_cast<double>(r.valid) / seconds, r.rejected, r.partials, r.recovered, r.failed, r.wrong);
+  };
+
+  std::printf("noise_bench: %us per run, seed %u, 37us clock, spike in 50%% of frames, ISR latency 0-%uus\n", seconds,
+              seed, isr_latency_ns / 1000);
+  uint32_t wrong = 0;
+  for (const Profile &p : profiles) {
+    std::printf("  %s\n", p.name);
+    print_header();
+    for (uint32_t f : filters_us) {
+      Run r = run(p, f, isr_latency_ns, seconds, seed);
+      print_run(f, r);
+      if (f <= MAX_FILTER_US) wrong += r.wrong;
+    }
+  }
+
+  // Longer filters only help while every real edge still reaches the ISR at least the filter
+  // length after the previous one
+  for (uint32_t latency_us : {8u, 12u, 16u}) {
+    std::printf("  %s, ISR latency 0-%uus\n", profiles[1].name, latency_us);
+    print_header();
+    for (uint32_t f : {10u, 18u, 25u, 30u}) {
+      Run r = run(profiles[1], f, latency_us * 1000, seconds, seed);
+      print_run(f, r);
+      if (f <= MAX_FILTER_US) wrong += r.wrong;
+    }
+  }
+
+  std::printf("  exhaustive single duplicated bit, temp 80-104 x heater/pump/light\n");
+  std::printf("    %-16s %6s %7s %8s %8s %8s %6s\n", "context", "spans", "passed", "shifted", "resync+", "resync-",
+              "wrong");
+  const Context contexts[] = {
+      {"none", false, false, false},
+      {"same frame", true, false, false},
+      {"temp - 1", true, true, false},
+      {"temp - 1, next", true, true, true},
+  };
+  for (const Context &c : contexts) {
+    Exhaustive e = exhaustive(c);
+    std::printf("    %-16s %6u %7u %8u %8u %8u %6u\n", c.name, e.spans, e.passed, e.shifted, e.recovered, e.failed,
+                e.wrong);
+  }
+  return wrong ? 1 : 0;
+}
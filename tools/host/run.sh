@@ -0,0 +1,47 @@
+#!/bin/sh
+# Build esp32-spa.h for the host against the stand-in headers in stubs/ and run a harness.
+#
+#   tools/host/run.sh stream    # loopback stream: one normal and one slow client for 20 s
+#   tools/host/run.sh decode    # descriptor decode vs the hand-written decode it replaced
+#   tools/host/run.sh latency   # press-to-publish latency against the GS100 display emulator
+#   tools/host/run.sh noise     # valid frames/s on a noisy clock line per glitch_filter setting
+#
+# Needs g++ (C++17) and python3. Binaries go to tools/host/build/.
+set -eu
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+OUT="$HERE/build"
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2 -g -Wall -Wextra -Wno-unused-parameter}
+
+mkdir -p "$OUT"
+
+build() {
+  "$CXX" -std=gnu++17 $CXXFLAGS -I"$HERE" -I"$HERE/stubs" -I"$ROOT/esp32-spa/inputs" \
+    -o "$OUT/$1" "$HERE/$1.cpp" "$HERE/host.cpp"
+}
+
+run_stream() {
+  build stream_loopback
+  port=${STREAM_PORT:-17260}
+  token=loopback-token
+  "$OUT/stream_loopback" "$port" "$token" 20 &
+  dev=$!
+  sleep 1
+  python3 "$ROOT/tools/stream_client.py" 127.0.0.1 --port "$port" --token "$token" --seconds 15 --slow &
+  slow=$!
+  status=0
+  python3 "$ROOT/tools/stream_client.py" 127.0.0.1 --port "$port" --token "$token" --seconds 15 --min-fps 45 || status=1
+  wait "$slow" || status=1
+  wait "$dev" || status=1
+  return $status
+}
+
+case "${1:-}" in
+  stream) run_stream ;;
+  decode) build decode_bench && "$OUT/decode_bench" ;;
+  latency) build latency_bench && "$OUT/latency_bench" ;;
+  noise) build noise_bench && "$OUT/noise_bench" ;;
+  *) echo "usage: $0 stream|decode|latency|noise" >&2; exit 2 ;;
+esac
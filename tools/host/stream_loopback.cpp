@@ -0,0 +1,42 @@
+// Stand-in device for the raw-frame stream: runs HotTubDisplaySensor in real time on the host,
+// fed by the bus simulator, with the UDP stream bound to the given port. Point
+// tools/stream_client.py at 127.0.0.1 to measure throughput, or attach a --slow client and
+// check that loop() time and the other subscriber's throughput are unaffected.
+//
+//   stream_loopback [port] [token] [seconds]
+
+#include "gs100_bus.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv) {
+  uint16_t port = argc > 1 ? static_cast<uint16_t>(std::atoi(argv[1])) : 7260;
+  const char *token = argc > 2 ? argv[2] : "loopback-token";
+  uint32_t seconds = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 20;
+
+  host::network_up = true;
+  host::log_level = 2;
+
+  esp32_spa::HotTubDisplaySensor spa;
+  spa.set_stream_port(port);
+  spa.set_stream_token(token);
+  spa.set_stream_max_subscribers(4);
+  spa.setup();
+
+  // Measured temperature ramps 100..104 F, one step every 5 s
+  gs100::Status st;
+  st.pump = true;
+  gs100::BusSim bus(spa, [&](uint32_t now_ms) { return gs100::temp_frame(100 + (now_ms / 5000) % 5, st); });
+  bus.realtime = true;
+
+  for (uint32_t s = 0; s < seconds; s += 5) {
+    bus.run_for_ms(5000);
+    std::printf("stream_loopback: t=%us frames=%u packets=%u send_drops=%u loop avg=%.1fus max=%.1fus\n",
+                static_cast<unsigned>(s + 5), static_cast<unsigned>(bus.frames_sent),
+                static_cast<unsigned>(spa.stream_packets_sent()), static_cast<unsigned>(spa.stream_send_drops()),
+                bus.loop_calls ? bus.loop_total_ns / 1e3 / bus.loop_calls : 0.0, bus.loop_max_ns / 1e3);
+    std::fflush(stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+#define IRAM_ATTR
+
+typedef int gpio_num_t;
+typedef enum { GPIO_INTR_DISABLE, GPIO_INTR_POSEDGE } gpio_int_type_t;
+typedef enum { GPIO_MODE_INPUT, GPIO_MODE_OUTPUT } gpio_mode_t;
+typedef enum { GPIO_PULLDOWN_DISABLE } gpio_pulldown_t;
+typedef enum { GPIO_PULLUP_DISABLE } gpio_pullup_t;
+
+typedef struct {
+  uint64_t pin_bit_mask;
+  gpio_mode_t mode;
+  gpio_pullup_t pull_up_en;
+  gpio_pulldown_t pull_down_en;
+  gpio_int_type_t intr_type;
+} gpio_config_t;
+
+int gpio_config(const gpio_config_t *conf);
+int gpio_install_isr_service(int flags);
+int gpio_isr_handler_add(gpio_num_t pin, void (*handler)(void *), void *arg);
+int gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t type);
+int gpio_set_direction(gpio_num_t pin, gpio_mode_t mode);
+int gpio_set_level(gpio_num_t pin, uint32_t level);
+int gpio_get_level(gpio_num_t pin);
@@ -0,0 +1,25 @@
+#pragma once
+// Host stand-in for ESPHome's umbrella header: just the parts esp32-spa.h uses.
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "esphome/core/log.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/binary_sensor/binary_sensor.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+
+namespace esphome {
+
+uint32_t millis();
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+
+ protected:
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+};
+
+}  // namespace esphome
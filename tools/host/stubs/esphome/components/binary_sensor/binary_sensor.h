@@ -0,0 +1,27 @@
+#pragma once
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace binary_sensor {
+
+class BinarySensor {
+ public:
+  void publish_state(bool state) {
+    this->state = state;
+    this->has_state_ = true;
+    for (auto &cb : callbacks_) cb(state);
+  }
+  void invalidate_state() { this->has_state_ = false; }
+  bool has_state() const { return has_state_; }
+  void add_on_state_callback(std::function<void(bool)> &&cb) { callbacks_.push_back(std::move(cb)); }
+  bool state{false};
+
+ protected:
+  bool has_state_{false};
+  std::vector<std::function<void(bool)>> callbacks_;
+};
+
+}  // namespace binary_sensor
+}  // namespace esphome
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace esphome {
+namespace network {
+
+bool is_connected();
+
+}  // namespace network
+}  // namespace esphome
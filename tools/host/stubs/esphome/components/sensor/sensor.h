@@ -0,0 +1,24 @@
+#pragma once
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    for (auto &cb : callbacks_) cb(state);
+  }
+  void add_on_state_callback(std::function<void(float)> &&cb) { callbacks_.push_back(std::move(cb)); }
+  float state{NAN};
+
+ protected:
+  std::vector<std::function<void(float)>> callbacks_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,24 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor {
+ public:
+  void publish_state(const std::string &state) {
+    this->state = state;
+    for (auto &cb : callbacks_) cb(state);
+  }
+  void add_on_state_callback(std::function<void(std::string)> &&cb) { callbacks_.push_back(std::move(cb)); }
+  std::string state;
+
+ protected:
+  std::vector<std::function<void(std::string)>> callbacks_;
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
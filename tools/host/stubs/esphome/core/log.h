@@ -0,0 +1,8 @@
+#pragma once
+#include "../../../host.h"
+
+#define ESP_LOGE(tag, ...) host::log('E', tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) host::log('W', tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) host::log('I', tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) host::log('D', tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ((void) 0)
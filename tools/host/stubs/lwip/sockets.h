@@ -0,0 +1,8 @@
+#pragma once
+// lwIP's BSD socket API maps directly onto the host's
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
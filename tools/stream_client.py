@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Subscribe to the esp32-spa raw-frame stream and report throughput.
+
+    stream_client.py HOST --token TOKEN [--port 7260] [--seconds 30]
+
+Prints packets, frames per second, lost packets (sequence gaps), the device-side counters
+carried in each packet header, and the frame spacing derived from the capture timestamps.
+
+--slow turns it into a deliberately slow subscriber: a tiny receive buffer and one read per
+second. Run it next to a normal client to check that a slow subscriber only loses its own
+packets and does not reduce the other client's rate (or, with tools/host/stream_loopback,
+the device's loop() time).
+
+--min-fps makes the exit status non-zero when the frame rate falls below the given value.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+HEADER = struct.Struct('<4sBBH5I')  # magic, version, frame count, sequence, 5 counters
+ENTRY = struct.Struct('<II')        # timestamp_us, (bits << 24) | raw
+COUNTERS = ('captured', 'partial', 'ring_overruns', 'send_drops', 'glitches')
+KEEPALIVE_S = 5.0                   # the device drops subscribers after 15 s of silence
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('host')
+    ap.add_argument('--port', type=int, default=7260)
+    ap.add_argument('--token', required=True)
+    ap.add_argument('--seconds', type=float, default=30.0)
+    ap.add_argument('--slow', action='store_true', help='act as a slow subscriber')
+    ap.add_argument('--min-fps', type=float, default=0.0)
+    args = ap.parse_args()
+
+    dest = (args.host, args.port)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    if args.slow:
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1024)
+    sock.settimeout(0.5)
+    sub = b'SUB ' + args.token.encode()
+
+    packets = frames = lost = 0
+    first_counters = last_counters = None
+    last_seq = last_ts = None
+    spacing = []
+    backwards = 0
+
+    sock.sendto(sub, dest)
+    start = last_keepalive = time.monotonic()
+    try:
+        while time.monotonic() - start < args.seconds:
+            now = time.monotonic()
+            if now - last_keepalive >= KEEPALIVE_S:
+                sock.sendto(sub, dest)
+                last_keepalive = now
+            if args.slow:
+                time.sleep(1.0)
+            try:
+                data = sock.recv(2048)
+            except socket.timeout:
+                continue
+            if len(data) < HEADER.size:
+                continue
+            magic, version, count, seq, *counters = HEADER.unpack_from(data)
+            if magic != b'SPAF' or len(data) < HEADER.size + count * ENTRY.size:
+                continue
+            packets += 1
+            if last_seq is not None:
+                lost += (seq - last_seq - 1) & 0xFFFF
+            last_seq = seq
+            if first_counters is None:
+                first_counters = counters
+            last_counters = counters
+            for i in range(count):
+                ts, word = ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+                frames += 1
+                if last_ts is not None:
+                    delta = (ts - last_ts) & 0xFFFFFFFF
+                    if delta == 0 or delta > 0x80000000:
+                        backwards += 1
+                    else:
+                        spacing.append(delta / 1000.0)
+                last_ts = ts
+    finally:
+        sock.sendto(b'BYE ' + args.token.encode(), dest)
+
+    elapsed = time.monotonic() - start
+    fps = frames / elapsed
+    role = 'slow subscriber' if args.slow else 'subscriber'
+    print(f'{role}: {elapsed:.1f}s packets={packets} frames={frames} ({fps:.1f} frames/s) lost_packets={lost}')
+    if first_counters is not None:
+        deltas = ' '.join(f'{n}=+{(b - a) & 0xFFFFFFFF}' for n, a, b in zip(COUNTERS, first_counters, last_counters))
+        print(f'  device counters: {deltas}')
+    if spacing:
+        spacing.sort()
+        print(f'  frame spacing ms: min={spacing[0]:.2f} median={spacing[len(spacing) // 2]:.2f} '
+              f'max={spacing[-1]:.2f} non-increasing={backwards}')
+    if fps < args.min_fps:
+        print(f'FAIL: {fps:.1f} frames/s is below --min-fps {args.min_fps}')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())